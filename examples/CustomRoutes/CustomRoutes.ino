@@ -10,6 +10,7 @@
  * Custom routes demonstrated:
  * - GET  /ping        → simple health check
  * - GET  /status      → JSON device status
+ * - GET  /info        → JSON streamed in chunks (no String buffer)
  *
  * Hardware required:
  * - ESP32 development board
@@ -68,6 +69,20 @@ void setup() {
       "}";
     })
 
+    // Streamed JSON route: written in chunks, no heap-sized String
+    .addGetJsonRoute("/info", [](JsonStreamWriter& json) {
+      json.beginObject()
+        .field("chip", ESP.getChipModel())
+        .field("free_heap", ESP.getFreeHeap())
+        .field("rssi", WiFi.RSSI())
+        .key("networks").beginArray();
+      for (const String& ssid : provisioner.getNetworks()) {
+        json.value(ssid);
+      }
+      json.endArray()
+        .endObject();
+    })
+
     // ----- Callbacks -----
     .onConnected(onWiFiConnected)
     .onFailed(onWiFiFailed)
@@ -101,6 +116,7 @@ void onWiFiConnected() {
   Serial.println("Custom routes available:");
   Serial.println("  GET  /ping");
   Serial.println("  GET  /status");
+  Serial.println("  GET  /info");
   Serial.println("========================\n");
 }
 
@@ -199,8 +199,8 @@ void onConnected() {
   Serial.print("mDNS: http://iot-device.local\n");
 }
 
-void onFailed(uint8_t retryCount) {
-  Serial.printf("Connection attempt %d failed\n", retryCount);
+void onFailed(uint8_t retryCount, uint8_t reason) {
+  Serial.printf("Connection failed after %d retries (reason %d)\n", retryCount, reason);
 
   // In production, you might:
   // - Log to local storage
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+Generates src/PortalAssets.h from the captive portal sources in this folder.
+
+Pipeline, for every asset: minify, gzip, embed as a constexpr byte array
+together with its uncompressed size and a content hash (used as ETag).
+The deflate window is limited to PORTAL_GZ_WINDOW bytes so the firmware can
+inflate an asset for clients without gzip through a buffer of that size.
+
+portal.css and portal.js are served under content-hashed URLs, so browsers
+can cache them for good; index.html refers to them through the {{PORTAL_CSS}}
+and {{PORTAL_JS}} placeholders. The page is emitted in two variants, with
+and without the block between <!-- reset-password --> and
+<!-- /reset-password -->.
+
+The minifiers are deliberately conservative (comments and layout
+whitespace only, line breaks kept in scripts) so they can't change what
+the sources mean.
+
+Usage:
+    python3 extras/portal/build_portal.py           # regenerate the header
+    python3 extras/portal/build_portal.py --check   # fail if it is out of date
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import sys
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+OUTPUT = os.path.normpath(os.path.join(HERE, "..", "..", "src", "PortalAssets.h"))
+
+RESET_BLOCK = re.compile(r"[ \t]*<!-- reset-password -->.*?<!-- /reset-password -->\n", re.S)
+RESET_MARKERS = re.compile(r"[ \t]*<!-- /?reset-password -->\n")
+
+# Deflate window, as a power of two (zlib wbits)
+WINDOW_BITS = 11
+
+
+# ===== Minifiers =====
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.S)
+    text = re.sub(r">\s+<", "><", text)
+    text = re.sub(r"\s*\n\s*", " ", text)
+    return text.strip()
+
+
+def minify_css(text):
+    # Quoted strings (content: "...") are kept as they are
+    parts = re.split(r"(\"[^\"]*\"|'[^']*')", text)
+    for i in range(0, len(parts), 2):
+        part = re.sub(r"/\*.*?\*/", "", parts[i], flags=re.S)
+        part = re.sub(r"\s+", " ", part)
+        part = re.sub(r"\s*([{};,>])\s*", r"\1", part)
+        part = re.sub(r":\s+", ":", part)
+        parts[i] = part.replace(";}", "}")
+    return "".join(parts).strip()
+
+
+def minify_js(text):
+    """Drops comments and indentation. Strings, template literals and regex
+    literals are copied verbatim; line breaks are kept so automatic
+    semicolon insertion behaves exactly as in the source."""
+    out = []
+    i = 0
+    n = len(text)
+    braces = []  # Template literal nesting: depth of ${ } per level
+    last = ""    # Last significant character, to tell regex from division
+
+    while i < n:
+        c = text[i]
+
+        if c in "'\"":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == "\\" else 1
+            out.append(text[i:j + 1])
+            i = j + 1
+            last = c
+        elif c == "`" or (c == "}" and braces and braces[-1] == 0):
+            # Template literal text, up to the closing backtick or next ${
+            if c == "}":
+                braces.pop()
+            j = i + 1
+            while j < n and text[j] != "`" and not text.startswith("${", j):
+                j += 2 if text[j] == "\\" else 1
+            if text.startswith("${", j):
+                out.append(text[i:j + 2])
+                braces.append(0)
+                i = j + 2
+                last = "{"
+            else:
+                out.append(text[i:j + 1])
+                i = j + 1
+                last = "`"
+        elif text.startswith("//", i):
+            while i < n and text[i] != "\n":
+                i += 1
+        elif text.startswith("/*", i):
+            i = text.index("*/", i + 2) + 2
+        elif c == "/" and (last == "" or last in "(,=:[!&|?{};+-*%<>~^"):
+            # Regex literal
+            j = i + 1
+            in_class = False
+            while j < n and (text[j] != "/" or in_class):
+                if text[j] == "\\":
+                    j += 1
+                elif text[j] == "[":
+                    in_class = True
+                elif text[j] == "]":
+                    in_class = False
+                j += 1
+            out.append(text[i:j + 1])
+            i = j + 1
+            last = "/"
+        else:
+            if c == "{" and braces:
+                braces[-1] += 1
+            elif c == "}" and braces:
+                braces[-1] -= 1
+            out.append(c)
+            if not c.isspace():
+                last = c
+            i += 1
+
+    lines = (line.strip() for line in "".join(out).split("\n"))
+    return "\n".join(line for line in lines if line)
+
+
+# ===== Header generation =====
+
+def read(name):
+    with open(os.path.join(HERE, name), encoding="utf-8") as f:
+        return f.read()
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def compress(data):
+    # gzip container (wbits + 16) with a zero mtime, so the output is
+    # reproducible; back-references stay within the small window
+    packer = zlib.compressobj(9, zlib.DEFLATED, 16 + WINDOW_BITS, 9)
+    return packer.compress(data) + packer.flush()
+
+
+def c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return (
+        "constexpr uint8_t %s[] = {\n%s\n};\n"
+        "constexpr size_t %s_LEN = sizeof(%s);\n" % (name, "\n".join(lines), name, name)
+    )
+
+
+def asset(out, name, source, text):
+    raw = text.encode("utf-8")
+    packed = compress(raw)
+    digest = content_hash(raw)
+    out.append("// %s: %d bytes source, %d minified, %d gzipped"
+               % (name, len(source.encode("utf-8")), len(raw), len(packed)))
+    out.append("constexpr size_t %s_SIZE = %d;" % (name, len(raw)))
+    out.append('constexpr char %s_HASH[] = "%s";' % (name, digest))
+    out.append(c_array(name + "_GZ", packed))
+    return digest
+
+
+def generate():
+    out = [
+        "// Generated by extras/portal/build_portal.py from extras/portal/.",
+        "// Do not edit: change the sources and run the script again.",
+        "",
+        "#ifndef ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H",
+        "#define ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H",
+        "",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        "// Largest back-reference distance in the compressed assets",
+        "constexpr size_t PORTAL_GZ_WINDOW = %d;" % (1 << WINDOW_BITS),
+        "",
+    ]
+
+    css = read("portal.css")
+    js = read("portal.js")
+    css_path = "/portal-%s.css" % asset(out, "PORTAL_CSS", css, minify_css(css))[:8]
+    js_path = "/portal-%s.js" % asset(out, "PORTAL_JS", js, minify_js(js))[:8]
+    out.append('constexpr char PORTAL_CSS_PATH[] = "%s";' % css_path)
+    out.append('constexpr char PORTAL_JS_PATH[] = "%s";' % js_path)
+    out.append("")
+
+    html = read("index.html").replace("{{PORTAL_CSS}}", css_path).replace("{{PORTAL_JS}}", js_path)
+    plain = RESET_BLOCK.sub("", html)
+    with_reset = RESET_MARKERS.sub("", html)
+    asset(out, "PORTAL_HTML", plain, minify_html(plain))
+    asset(out, "PORTAL_HTML_RESET", with_reset, minify_html(with_reset))
+
+    out.append("#endif // ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build the captive portal assets header.")
+    parser.add_argument("--check", action="store_true",
+                        help="exit with an error if the header is not up to date")
+    args = parser.parse_args()
+
+    header = generate()
+    relative = os.path.relpath(OUTPUT)
+
+    if args.check:
+        try:
+            with open(OUTPUT, encoding="utf-8") as f:
+                current = f.read()
+        except FileNotFoundError:
+            current = None
+        if current != header:
+            print("%s is out of date, run extras/portal/build_portal.py" % relative)
+            return 1
+        print("%s is up to date" % relative)
+        return 0
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write(header)
+
+    print("Wrote %s" % relative)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,209 @@
+let networks = [];
+
+function showStatus(message, type) {
+    const status = document.getElementById('status');
+    status.textContent = message;
+    status.className = 'status ' + type;
+    status.classList.remove('hidden');
+}
+
+function hideStatus() {
+    document.getElementById('status').classList.add('hidden');
+}
+
+function toggleAdvanced() {
+    const advanced = document.getElementById('advanced');
+    advanced.classList.toggle('hidden');
+}
+
+function scanNetworks() {
+    showStatus('Scanning for networks...', 'info');
+
+    fetch('/scan')
+        .then(response => {
+            // First scan still running on the device
+            if (response.status === 202) {
+                setTimeout(scanNetworks, 1000);
+                return null;
+            }
+            return response.json();
+        })
+        .then(data => {
+            if (!data) return;
+            networks = data;
+            displayNetworks(data);
+            hideStatus();
+        })
+        .catch(error => {
+            showStatus('Scan failed. Please try again.', 'error');
+        });
+}
+
+// SSIDs come from any AP in range: only ever insert them as text
+function networkItem(text) {
+    const item = document.createElement('div');
+    item.className = 'network-item';
+
+    const label = document.createElement('span');
+    label.textContent = text;
+    item.appendChild(label);
+    return item;
+}
+
+function displayNetworks(networks) {
+    const container = document.getElementById('networks');
+    container.replaceChildren();
+
+    if (networks.length === 0) {
+        container.appendChild(networkItem('No networks found'));
+    } else {
+        networks.forEach((network, index) => {
+            const signal = network.rssi;
+            const item = networkItem(network.ssid);
+
+            const bars = document.createElement('span');
+            bars.className = 'signal';
+            bars.textContent = (signal > -50 ? '▂▄▆█' : signal > -60 ? '▂▄▆' : signal > -70 ? '▂▄' : '▂') + ' ';
+            if (network.secure) {
+                const lock = document.createElement('span');
+                lock.className = 'lock-icon';
+                bars.appendChild(lock);
+            }
+            item.appendChild(bars);
+
+            item.onclick = () => selectNetwork(index);
+            container.appendChild(item);
+        });
+    }
+
+    container.classList.remove('hidden');
+}
+
+function selectNetwork(index) {
+    const network = networks[index];
+    document.getElementById('ssid').value = network.ssid;
+
+    // Highlight selected
+    document.querySelectorAll('#networks .network-item').forEach((item, i) => {
+        if (i === index) {
+            item.classList.add('selected');
+        } else {
+            item.classList.remove('selected');
+        }
+    });
+
+    // Focus password field
+    document.getElementById('password').focus();
+}
+
+function loadSaved() {
+    fetch('/networks')
+        .then(response => response.json())
+        .then(data => {
+            const saved = document.getElementById('saved');
+            if (data.length === 0) {
+                saved.classList.add('hidden');
+                return;
+            }
+
+            const list = document.getElementById('savedList');
+            list.replaceChildren();
+
+            data.forEach(network => {
+                const item = networkItem(network.ssid);
+
+                const button = document.createElement('button');
+                button.type = 'button';
+                button.className = 'remove-btn';
+                button.textContent = 'Remove';
+                button.onclick = () => removeSaved(network.ssid);
+                item.appendChild(button);
+
+                list.appendChild(item);
+            });
+
+            saved.classList.remove('hidden');
+        })
+        .catch(() => {});
+}
+
+function removeSaved(ssid) {
+    fetch('/networks/remove', {
+        method: 'POST',
+        body: new URLSearchParams({ ssid: ssid })
+    }).then(loadSaved);
+}
+
+function saveConfig(event) {
+    // Prevent the form to trigger default behaviour (pt. 1)
+    event.preventDefault();
+
+    const formData = new FormData(event.target);
+    const submitBtn = document.getElementById('submitBtn');
+
+    submitBtn.disabled = true;
+    submitBtn.textContent = 'Connecting...';
+    showStatus('Connecting to ' + formData.get('ssid') + '...', 'info');
+
+    fetch('/save', {
+        method: 'POST',
+        body: new URLSearchParams(formData)
+    })
+    .then(response => {
+        if (response.ok) {
+            missedPolls = 0;
+            setTimeout(pollStatus, 500);
+        } else {
+            return response.text().then(text => { throw new Error(text); });
+        }
+    })
+    .catch(error => {
+        saveFailed(error.message || 'Failed to save configuration. Please try again.');
+    });
+
+    // Prevent the form to trigger default behaviour (pt. 2)
+    return false;
+}
+
+function saveFailed(message) {
+    const submitBtn = document.getElementById('submitBtn');
+    showStatus(message, 'error');
+    submitBtn.disabled = false;
+    submitBtn.textContent = 'Save Configuration';
+}
+
+// The AP may hop to the router's channel during the test: tolerate
+// a few missed polls before giving up
+let missedPolls = 0;
+
+function pollStatus() {
+    fetch('/status')
+        .then(response => response.json())
+        .then(data => {
+            missedPolls = 0;
+            if (data.state === 'testing') {
+                showStatus(data.step === 'obtaining_ip' ? 'Obtaining IP address...' : 'Connecting...', 'info');
+                setTimeout(pollStatus, 500);
+            } else if (data.state === 'connected') {
+                showStatus('Connected! Device IP: ' + data.ip + '. This setup network will now close.', 'success');
+                document.getElementById('submitBtn').textContent = 'Saved';
+            } else if (data.state === 'failed') {
+                saveFailed('Could not connect: ' + data.message + ' (reason ' + data.reason + ')');
+            } else {
+                saveFailed('Connection test was interrupted. Please try again.');
+            }
+        })
+        .catch(() => {
+            if (++missedPolls < 20) {
+                setTimeout(pollStatus, 1000);
+            } else {
+                saveFailed('Lost contact with the device. Please reconnect and try again.');
+            }
+        });
+}
+
+// Auto-scan on load
+window.addEventListener('load', function() {
+    loadSaved();
+    setTimeout(scanNetworks, 500);
+});
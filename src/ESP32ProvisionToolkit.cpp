@@ -4,40 +4,176 @@
  */
 
 #include "ESP32ProvisionToolkit.h"
+#include "PortalAssets.h"
 #include <esp_wifi.h>
+#include <lwip/sockets.h>
+
+// The ROM inflater serves the portal to the rare client without gzip
+// support; without it, such clients get 406 Not Acceptable
+#if __has_include(<rom/miniz.h>)
+#include <rom/miniz.h>
+#include <new>
+#define PORTAL_IDENTITY_FALLBACK
+#endif
+
+// RequestHandler takes the URI by reference and gained a server-aware
+// canHandle() in arduino-esp32 3.0
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+typedef const String& RequestUri;
+#define REQUEST_HANDLER_SERVER_ARG
+#else
+typedef String RequestUri;
+#endif
 
 // Static instance pointer for web server callbacks
 ESP32ProvisionToolkit* ESP32ProvisionToolkit::_instance = nullptr;
 
 // NVS namespace and keys
 #define NVS_NAMESPACE "wifiprov"
-#define NVS_SSID "ssid"
-#define NVS_PASSWORD "password"
+#define NVS_NETWORKS "networks"
+#define NVS_LEASE "lease"
 #define NVS_RESET_PWD "reset_pwd"
 #define NVS_BOOT_COUNT "boot_count"
 #define NVS_BOOT_TIME "boot_time"
 
+// Holds the service task's lock for a scope; no-op without a service task
+class ServiceLock {
+public:
+    explicit ServiceLock(SemaphoreHandle_t lock) : _lock(lock) {
+        if (_lock) xSemaphoreTakeRecursive(_lock, portMAX_DELAY);
+    }
+    ~ServiceLock() {
+        if (_lock) xSemaphoreGiveRecursive(_lock);
+    }
+
+private:
+    SemaphoreHandle_t _lock;
+};
+
+// Request headers the web servers keep for the handlers
+static const char* COLLECTED_HEADERS[] = { "Accept-Encoding", "If-None-Match" };
+
+// Connectivity checks sent by each OS on joining a network. Any answer but
+// the expected one opens the captive sheet; redirecting straight to the
+// portal's IP skips the DNS lookup and redirect of the generic path.
+enum ProbeOS : uint8_t { PROBE_ANDROID, PROBE_APPLE, PROBE_WINDOWS, PROBE_FIREFOX };
+static const char* const PROBE_OS_NAMES[] = { "Android", "Apple", "Windows", "Firefox" };
+
+struct CaptiveProbe {
+    const char* path;
+    ProbeOS os;
+};
+
+static const CaptiveProbe CAPTIVE_PROBES[] = {
+    { "/generate_204", PROBE_ANDROID },
+    { "/gen_204", PROBE_ANDROID },
+    { "/hotspot-detect.html", PROBE_APPLE },
+    { "/library/test/success.html", PROBE_APPLE },
+    { "/connecttest.txt", PROBE_WINDOWS },
+    { "/ncsi.txt", PROBE_WINDOWS },
+    { "/redirect", PROBE_WINDOWS },
+    { "/canonical.html", PROBE_FIREFOX },
+    { "/success.txt", PROBE_FIREFOX },
+};
+
+// Single-network keys of earlier versions, migrated on load
+#define NVS_SSID "ssid"
+#define NVS_PASSWORD "password"
+
+// FNV-1a: ties a cached lease to its network, tags the portal theme
+static uint32_t fnv1a(const char* text) {
+    uint32_t hash = 2166136261u;
+    while (*text) {
+        hash = (hash ^ (uint8_t)*text++) * 16777619u;
+    }
+    return hash;
+}
+
 ESP32ProvisionToolkit::ESP32ProvisionToolkit() :
     _state(STATE_INIT),
     _retryCount(0),
     _lastRetryTime(0),
+    _retryDelay(0),
+    _retryPolicy(&_fixedRetryPolicy),
+    _lastFailure(FAILURE_NONE),
+    _failureReason(0),
+    _handshakeTimeouts(0),
+    _waitingForAP(false),
+    _scanInProgress(false),
+    _rankRequested(false),
+    _rankReady(false),
+    _scanResultCount(0),
+    _scanResultsValid(false),
+    _scanCacheTime(0),
     _apStartTime(0),
+    _lastBackgroundAttempt(0),
     _buttonPressStart(0),
     _buttonPressed(false),
+    _networkCount(0),
+    _networkSequence(0),
+    _activeNetwork(-1),
+    _candidateCount(0),
+    _candidateIndex(0),
+    _skipDirectedConnect(false),
+    _directedAttempt(false),
+    _usingCachedLease(false),
+    _skipCachedLease(false),
+    _leaseRevalidatePending(false),
+    _connectedTime(0),
+    _wifiEventId(0),
+    _connectInProgress(false),
+    _connectStartTime(0),
+    _staConnected(false),
+    _staGotIP(false),
+    _ipEventPending(false),
+    _staDisconnected(false),
+    _lastDisconnectReason(0),
+    _reconfigure(RECONFIGURE_NONE),
+    _switchPending(false),
+    _testState(TEST_IDLE),
+    _testReason(0),
+    _testMessage(""),
+    _testDoneTime(0),
+    _themeHash(fnv1a("")),
+    _probedOS(0),
     _dnsServer(nullptr),
+    _fastDNS(nullptr),
     _webServer(nullptr),
+    _routes(nullptr),
+    _webServerActive(false),
+    _webServerListening(false),
     _onConnectedCallback(nullptr),
     _onFailedCallback(nullptr),
+    _onFailedLegacyCallback(nullptr),
     _onAPModeCallback(nullptr),
     _onResetCallback(nullptr),
     _lastLedToggle(0),
-    _ledState(false)
+    _ledState(false),
+    _serviceTask(nullptr),
+    _lock(nullptr),
+    _serviceStop(false),
+    _serviceStopWaiter(nullptr)
 {
+    memset(_networks, 0, sizeof(_networks));
+    memset(_scanChannel, 0, sizeof(_scanChannel));
+    strcpy(_portalURL, "/");
+    _ssidSnapshot[0] = '\0';
+    memset(&_cachedLease, 0, sizeof(_cachedLease));
     _instance = this;
 }
 
 ESP32ProvisionToolkit::~ESP32ProvisionToolkit() {
+    if (_serviceTask) {
+        // Ask the task to exit between iterations and wait until it has: it
+        // may be asleep in select() on sockets deleted below
+        _serviceStopWaiter = xTaskGetCurrentTaskHandle();
+        _serviceStop = true;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vSemaphoreDelete(_lock);
+    }
+    if (_wifiEventId) WiFi.removeEvent(_wifiEventId);
     if (_dnsServer) delete _dnsServer;
+    if (_fastDNS) delete _fastDNS;
     if (_webServer) delete _webServer;
     _instance = nullptr;
 }
@@ -59,6 +195,38 @@ ESP32ProvisionToolkit& ESP32ProvisionToolkit::setAPTimeout(uint32_t milliseconds
     return *this;
 }
 
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setBackgroundReconnect(bool enable, uint32_t intervalMs) {
+    _config.backgroundReconnectEnabled = enable;
+    _config.backgroundReconnectInterval = intervalMs;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setScanCacheTTL(uint32_t milliseconds) {
+    _config.scanCacheTTL = milliseconds;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setPortalStylesheet(const char* css) {
+    _config.portalStylesheet = css;
+    _themeHash = fnv1a(css ? css : "");
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setFastDNS(bool enable) {
+    _config.fastDNSEnabled = enable;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setPortalPollBudget(uint32_t milliseconds) {
+    _config.portalPollBudget = milliseconds;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setHttpBackend(HttpBackend backend) {
+    _config.httpBackend = backend;
+    return *this;
+}
+
 ESP32ProvisionToolkit& ESP32ProvisionToolkit::setMaxRetries(uint8_t retries) {
     _config.maxRetries = retries;
     return *this;
@@ -66,6 +234,29 @@ ESP32ProvisionToolkit& ESP32ProvisionToolkit::setMaxRetries(uint8_t retries) {
 
 ESP32ProvisionToolkit& ESP32ProvisionToolkit::setRetryDelay(uint32_t milliseconds) {
     _config.retryDelay = milliseconds;
+    _fixedRetryPolicy.setDelay(milliseconds);
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setExponentialBackoff(uint32_t baseMs, uint32_t maxMs, bool jitter) {
+    _exponentialRetryPolicy.configure(baseMs, maxMs, jitter);
+    _retryPolicy = &_exponentialRetryPolicy;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setDecorrelatedJitterBackoff(uint32_t baseMs, uint32_t maxMs) {
+    _jitterRetryPolicy.configure(baseMs, maxMs);
+    _retryPolicy = &_jitterRetryPolicy;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setRetryPolicy(RetryPolicy* policy) {
+    _retryPolicy = policy ? policy : &_fixedRetryPolicy;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setConnectTimeout(uint32_t milliseconds) {
+    _config.connectTimeout = milliseconds;
     return *this;
 }
 
@@ -74,6 +265,49 @@ ESP32ProvisionToolkit& ESP32ProvisionToolkit::setAutoWipeOnMaxRetries(bool enabl
     return *this;
 }
 
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setFailFastOnAuthError(bool enable) {
+    _config.failFastOnAuthError = enable;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setTransientRetryDelay(uint32_t milliseconds) {
+    _config.transientRetryDelay = milliseconds;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setFastReconnect(bool enable) {
+    _config.fastReconnectEnabled = enable;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setStorePMK(bool enable) {
+    _config.storePmkEnabled = enable;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setStaticIP(
+    const IPAddress& ip,
+    const IPAddress& gateway,
+    const IPAddress& subnet,
+    const IPAddress& dns1,
+    const IPAddress& dns2
+) {
+    _config.staticIPEnabled = true;
+    _config.staticIP = ip;
+    _config.staticGateway = gateway;
+    _config.staticSubnet = subnet;
+    _config.staticDNS1 = dns1;
+    _config.staticDNS2 = dns2;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::enableLeaseCache(uint32_t maxAgeSeconds, uint32_t revalidateDelayMs) {
+    _config.leaseCacheEnabled = true;
+    _config.leaseCacheMaxAge = maxAgeSeconds;
+    _config.leaseRevalidateDelay = revalidateDelayMs;
+    return *this;
+}
+
 ESP32ProvisionToolkit& ESP32ProvisionToolkit::enableHardwareReset(int8_t pin, uint32_t durationMs, bool activeLow) {
     _config.hardwareResetEnabled = true;
     _config.resetButtonPin = pin;
@@ -125,6 +359,14 @@ ESP32ProvisionToolkit& ESP32ProvisionToolkit::enableDoubleRebootDetect(uint32_t
     return *this;
 }
 
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setServiceTask(bool enable, int8_t core, uint32_t stackSize, uint8_t priority) {
+    _config.serviceTaskEnabled = enable;
+    _config.serviceTaskCore = core;
+    _config.serviceTaskStackSize = stackSize;
+    _config.serviceTaskPriority = priority;
+    return *this;
+}
+
 ESP32ProvisionToolkit& ESP32ProvisionToolkit::setLogLevel(LogLevel level) {
     _config.logLevel = level;
     return *this;
@@ -137,6 +379,13 @@ ESP32ProvisionToolkit& ESP32ProvisionToolkit::onConnected(WiFiConnectedCallback
 
 ESP32ProvisionToolkit& ESP32ProvisionToolkit::onFailed(WiFiFailedCallback callback) {
     _onFailedCallback = callback;
+    _onFailedLegacyCallback = nullptr;
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::onFailed(WiFiFailedLegacyCallback callback) {
+    _onFailedLegacyCallback = callback;
+    _onFailedCallback = nullptr;
     return *this;
 }
 
@@ -160,12 +409,74 @@ bool ESP32ProvisionToolkit::begin() {
         checkDoubleReboot();
     }
 
+    // Subscribe to WiFi driver events for the connect engine
+    if (!_wifiEventId) {
+        _wifiEventId = WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+            handleWiFiEvent(event, info);
+        });
+    }
+
     // Load configuration
     _state = STATE_LOAD_CONFIG;
+
+    if (_config.serviceTaskEnabled && !_serviceTask) {
+        _lock = xSemaphoreCreateRecursiveMutex();
+        BaseType_t core = _config.serviceTaskCore < 0 ? tskNO_AFFINITY : _config.serviceTaskCore;
+        if (!_lock || xTaskCreatePinnedToCore(serviceTaskMain, "provisioner", _config.serviceTaskStackSize,
+                                              this, _config.serviceTaskPriority, &_serviceTask, core) != pdPASS) {
+            log(LOG_ERROR, "Failed to start service task, falling back to loop()");
+            if (_lock) vSemaphoreDelete(_lock);
+            _lock = nullptr;
+            _serviceTask = nullptr;
+        } else {
+            log(LOG_INFO, "Service task started on core %d", _config.serviceTaskCore);
+        }
+    }
+
     return true;
 }
 
 void ESP32ProvisionToolkit::loop() {
+    // The service task does the work
+    if (_serviceTask) return;
+
+    service();
+}
+
+void ESP32ProvisionToolkit::serviceTaskMain(void* arg) {
+    ESP32ProvisionToolkit* self = static_cast<ESP32ProvisionToolkit*>(arg);
+
+    while (!self->_serviceStop) {
+        int fds[HTTP_MAX_CLIENTS + 1];
+        size_t count = 0;
+        uint32_t idle = 0;
+
+        xSemaphoreTakeRecursive(self->_lock, portMAX_DELAY);
+        self->service();
+
+        // An active portal with a poll budget sleeps on its sockets between
+        // iterations. The lock is released first, so API calls never run
+        // inside an iteration.
+        if (self->_state == STATE_PROVISIONING_ACTIVE && self->_config.portalPollBudget > 0) {
+            count = self->portalPollFds(fds);
+            idle = self->_config.portalPollBudget < PORTAL_POLL_SLICE_MS ?
+                   self->_config.portalPollBudget : PORTAL_POLL_SLICE_MS;
+        }
+        xSemaphoreGiveRecursive(self->_lock);
+
+        // Lets lower priority tasks and waiting API calls in
+        if (idle > 0) {
+            waitForSockets(fds, count, idle);
+        } else {
+            vTaskDelay(1);
+        }
+    }
+
+    xTaskNotifyGive(self->_serviceStopWaiter);
+    vTaskDelete(nullptr);
+}
+
+void ESP32ProvisionToolkit::service() {
     // Handle reset button
     if (_config.hardwareResetEnabled) {
         checkHardwareReset();
@@ -176,6 +487,16 @@ void ESP32ProvisionToolkit::loop() {
         updateLED();
     }
 
+    // Credentials changed at runtime: switch over without a reboot
+    if (_reconfigure != RECONFIGURE_NONE) {
+        applyReconfigure();
+    }
+
+    // Collect background scan results
+    if (_scanInProgress) {
+        pollScan();
+    }
+
     // State machine
     switch (_state) {
         case STATE_INIT:
@@ -206,13 +527,19 @@ void ESP32ProvisionToolkit::loop() {
             handleStateProvisioningActive();
             break;
     }
+
+    // Close the listener if no mode took the server over
+    releaseWebServer();
 }
 
 void ESP32ProvisionToolkit::reset() {
+    ServiceLock lock(_lock);
     performReset("Programmatic reset");
 }
 
 // ===== Status Query =====
+// Lock-free: these read single-byte fields and the SSID snapshot, so they
+// never wait for a route handler, a PBKDF2 run or a retry delay
 
 bool ESP32ProvisionToolkit::isConnected() const {
     return _state == STATE_CONNECTED && WiFi.status() == WL_CONNECTED;
@@ -226,8 +553,28 @@ ProvisionerState ESP32ProvisionToolkit::getState() const {
     return _state;
 }
 
+uint8_t ESP32ProvisionToolkit::getRetryCount() const {
+    return _retryCount;
+}
+
+const RetryPolicy& ESP32ProvisionToolkit::getRetryPolicy() const {
+    return *_retryPolicy;
+}
+
+ConnectFailure ESP32ProvisionToolkit::getLastFailure() const {
+    return _lastFailure;
+}
+
+uint8_t ESP32ProvisionToolkit::getLastDisconnectReason() const {
+    return _failureReason;
+}
+
 String ESP32ProvisionToolkit::getSSID() const {
-    return _storedSSID;
+    char ssid[sizeof(_ssidSnapshot)];
+    portENTER_CRITICAL(&_ssidMux);
+    memcpy(ssid, _ssidSnapshot, sizeof(ssid));
+    portEXIT_CRITICAL(&_ssidMux);
+    return String(ssid);
 }
 
 IPAddress ESP32ProvisionToolkit::getLocalIP() const {
@@ -238,13 +585,20 @@ String ESP32ProvisionToolkit::getAPIP() const {
     return WiFi.softAPIP().toString();
 }
 
+DNSStats ESP32ProvisionToolkit::getDNSStats() const {
+    ServiceLock lock(_lock);
+    return _fastDNS ? _fastDNS->getStats() : DNSStats();
+}
+
 // ===== Custom Route Introspection =====
 
 bool ESP32ProvisionToolkit::hasCustomRoutes() const {
+    ServiceLock lock(_lock);
     return !_customRoutes.empty();
 }
 
 bool ESP32ProvisionToolkit::hasConnectedOnlyRoutes() const {
+    ServiceLock lock(_lock);
     for (const auto& route : _customRoutes) {
         if (route.scope == ROUTE_CONNECTED_ONLY) {
             return true;
@@ -254,6 +608,7 @@ bool ESP32ProvisionToolkit::hasConnectedOnlyRoutes() const {
 }
 
 bool ESP32ProvisionToolkit::hasProvisioningOnlyRoutes() const {
+    ServiceLock lock(_lock);
     for (const auto& route : _customRoutes) {
         if (route.scope == ROUTE_PROVISIONING_ONLY) {
             return true;
@@ -265,23 +620,100 @@ bool ESP32ProvisionToolkit::hasProvisioningOnlyRoutes() const {
 // ===== Manual Control =====
 
 bool ESP32ProvisionToolkit::setCredentials(const String& ssid, const String& password, bool reboot) {
+    ServiceLock lock(_lock);
+    bool running = _state != STATE_INIT && _state != STATE_LOAD_CONFIG;
+
+    // Switch live: the new network is tried first and saved only if it
+    // works, otherwise the saved networks are used again
+    if (!reboot && running && _networkCount > 0) {
+        if (ssid.length() == 0 || ssid.length() > 32 || password.length() > 64) {
+            log(LOG_ERROR, "Invalid credentials for %s", ssid.c_str());
+            return false;
+        }
+
+        _switchSSID = ssid;
+        _switchPassword = password;
+        _reconfigure = RECONFIGURE_SWITCH;
+        log(LOG_INFO, "Switching to %s", ssid.c_str());
+        return true;
+    }
+
     if (saveCredentials(ssid, password)) {
         log(LOG_INFO, "Credentials saved: %s", ssid.c_str());
         if (reboot) {
             delay(500);
             ESP.restart();
+        } else if (running) {
+            // Nothing to fall back to: keep them even if the network isn't up yet
+            _reconfigure = RECONFIGURE_RECONNECT;
         }
         return true;
     }
     return false;
 }
 
+// ===== Saved Networks =====
+
+bool ESP32ProvisionToolkit::addNetwork(const String& ssid, const String& password) {
+    ServiceLock lock(_lock);
+    if (!saveCredentials(ssid, password, false)) {
+        return false;
+    }
+
+    log(LOG_INFO, "Network saved: %s", ssid.c_str());
+    return true;
+}
+
+bool ESP32ProvisionToolkit::removeNetwork(const String& ssid) {
+    ServiceLock lock(_lock);
+    int8_t index = findNetwork(ssid);
+    if (index < 0) {
+        return false;
+    }
+
+    for (uint8_t i = index; i + 1 < _networkCount; i++) {
+        _networks[i] = _networks[i + 1];
+    }
+    _networkCount--;
+
+    if (_activeNetwork == index) {
+        _activeNetwork = -1;
+    } else if (_activeNetwork > index) {
+        _activeNetwork--;
+    }
+
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+
+    log(LOG_INFO, "Network removed: %s", ssid.c_str());
+    return persistNetworks();
+}
+
+uint8_t ESP32ProvisionToolkit::getNetworkCount() const {
+    ServiceLock lock(_lock);
+    return _networkCount;
+}
+
+std::vector<String> ESP32ProvisionToolkit::getNetworks() const {
+    ServiceLock lock(_lock);
+    std::vector<String> ssids;
+    ssids.reserve(_networkCount);
+    for (uint8_t i = 0; i < _networkCount; i++) {
+        ssids.push_back(_networks[i].ssid);
+    }
+    return ssids;
+}
+
 bool ESP32ProvisionToolkit::clearCredentials(bool reboot) {
+    ServiceLock lock(_lock);
     clearAllCredentials();
     log(LOG_INFO, "Credentials cleared");
     if (reboot) {
         delay(500);
         ESP.restart();
+    } else if (_state != STATE_INIT && _state != STATE_LOAD_CONFIG) {
+        _reconfigure = RECONFIGURE_PROVISION;
     }
     return true;
 }
@@ -294,33 +726,296 @@ bool ESP32ProvisionToolkit::loadCredentials() {
         return false;
     }
 
-    _storedSSID = _preferences.getString(NVS_SSID, "");
-    _storedPassword = _preferences.getString(NVS_PASSWORD, "");
+    _networkCount = 0;
+    size_t length = _preferences.getBytesLength(NVS_NETWORKS);
+    if (length > 0 && length % sizeof(StoredNetwork) == 0 && length <= sizeof(_networks)) {
+        _preferences.getBytes(NVS_NETWORKS, _networks, length);
+        _networkCount = length / sizeof(StoredNetwork);
+    }
+
+    // Single-network layout of earlier versions
+    String legacySSID = _networkCount == 0 ? _preferences.getString(NVS_SSID, "") : String("");
+    String legacyPassword = _networkCount == 0 ? _preferences.getString(NVS_PASSWORD, "") : String("");
 
     _preferences.end();
 
-    bool hasCredentials = _storedSSID.length() > 0;
-    log(LOG_DEBUG, "Loaded credentials: SSID=%s, hasPassword=%d",
-        _storedSSID.c_str(), _storedPassword.length() > 0);
+    if (legacySSID.length() > 0) {
+        log(LOG_INFO, "Migrating stored credentials to the network list");
+
+        StoredNetwork& network = _networks[0];
+        memset(&network, 0, sizeof(network));
+        strlcpy(network.ssid, legacySSID.c_str(), sizeof(network.ssid));
+        strlcpy(network.secret, legacyPassword.c_str(), sizeof(network.secret));
+        network.lastUsed = 1;
+        _networkCount = 1;
+
+        if (persistNetworks() && _preferences.begin(NVS_NAMESPACE, false)) {
+            _preferences.remove(NVS_SSID);
+            _preferences.remove(NVS_PASSWORD);
+            _preferences.end();
+        }
+    }
+
+    _networkSequence = 0;
+    bool derived = false;
+
+    for (uint8_t i = 0; i < _networkCount; i++) {
+        StoredNetwork& network = _networks[i];
+        network.ssid[sizeof(network.ssid) - 1] = '\0';
+        network.secret[sizeof(network.secret) - 1] = '\0';
+
+        if (network.lastUsed > _networkSequence) {
+            _networkSequence = network.lastUsed;
+        }
+
+        // Migrate stored passphrases to PMKs once, so later boots skip PBKDF2
+        if (_config.storePmkEnabled && !network.isPmk) {
+            String pmk = derivePMK(network.ssid, network.secret);
+            if (pmk.length() > 0) {
+                strlcpy(network.secret, pmk.c_str(), sizeof(network.secret));
+                network.isPmk = true;
+                derived = true;
+            }
+        }
+    }
+
+    if (derived) {
+        log(LOG_INFO, "Replacing stored passphrases with derived PMKs");
+        persistNetworks();
+    }
+
+    _activeNetwork = -1;
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+
+    if (_config.leaseCacheEnabled) {
+        loadLease();
+    }
+
+    log(LOG_DEBUG, "Loaded %u saved network(s)", _networkCount);
+
+    return _networkCount > 0;
+}
+
+bool ESP32ProvisionToolkit::saveCredentials(const String& ssid, const String& password, bool preferred) {
+    if (ssid.length() == 0 || ssid.length() > 32 || password.length() > 64) {
+        log(LOG_ERROR, "Invalid credentials for %s", ssid.c_str());
+        return false;
+    }
+
+    // Derive the PMK now so connects don't run the 4096-round PBKDF2 again
+    String secret = password;
+    bool isPmk = false;
+    if (_config.storePmkEnabled) {
+        String pmk = derivePMK(ssid, password);
+        if (pmk.length() > 0) {
+            secret = pmk;
+            isPmk = true;
+        }
+    }
+
+    int8_t index = findNetwork(ssid);
+
+    if (index < 0) {
+        if (_networkCount < MAX_STORED_NETWORKS) {
+            index = _networkCount++;
+        } else {
+            // Full: replace the network with the worst history, oldest first
+            index = 0;
+            for (uint8_t i = 1; i < _networkCount; i++) {
+                int score = __builtin_popcount(_networks[i].history);
+                int worst = __builtin_popcount(_networks[index].history);
+                if (score < worst || (score == worst && _networks[i].lastUsed < _networks[index].lastUsed)) {
+                    index = i;
+                }
+            }
+            log(LOG_INFO, "Network list full, replacing %s", _networks[index].ssid);
+        }
+
+        memset(&_networks[index], 0, sizeof(StoredNetwork));
+        strlcpy(_networks[index].ssid, ssid.c_str(), sizeof(_networks[index].ssid));
+    } else if (secret != _networks[index].secret) {
+        // Past outcomes were for the old password
+        _networks[index].history = 0;
+    }
+
+    StoredNetwork& network = _networks[index];
+    strlcpy(network.secret, secret.c_str(), sizeof(network.secret));
+    network.isPmk = isPmk;
+
+    // Explicitly configured networks are tried first
+    if (preferred) {
+        network.lastUsed = ++_networkSequence;
+    }
+
+    // Indexes may have moved: rank again on the next attempt
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+
+    if (!persistNetworks()) {
+        return false;
+    }
+
+    if (preferred || _activeNetwork < 0) {
+        selectNetwork(index);
+    }
 
-    return hasCredentials;
+    return true;
 }
 
-bool ESP32ProvisionToolkit::saveCredentials(const String& ssid, const String& password) {
+bool ESP32ProvisionToolkit::persistNetworks() {
     if (!_preferences.begin(NVS_NAMESPACE, false)) {
         log(LOG_ERROR, "Failed to open NVS for writing");
         return false;
     }
 
-    _preferences.putString(NVS_SSID, ssid);
-    _preferences.putString(NVS_PASSWORD, password);
+    bool ok = true;
+    if (_networkCount == 0) {
+        _preferences.remove(NVS_NETWORKS);
+    } else {
+        size_t length = _networkCount * sizeof(StoredNetwork);
+        ok = _preferences.putBytes(NVS_NETWORKS, _networks, length) == length;
+    }
 
     _preferences.end();
 
+    if (!ok) {
+        log(LOG_ERROR, "Failed to save network list");
+    }
+
+    return ok;
+}
+
+int8_t ESP32ProvisionToolkit::findNetwork(const String& ssid) const {
+    for (uint8_t i = 0; i < _networkCount; i++) {
+        if (ssid == _networks[i].ssid) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ESP32ProvisionToolkit::selectNetwork(uint8_t index) {
+    _activeNetwork = index;
+    setCurrentNetwork(_networks[index].ssid, _networks[index].secret);
+}
+
+void ESP32ProvisionToolkit::setCurrentNetwork(const String& ssid, const String& secret) {
     _storedSSID = ssid;
-    _storedPassword = password;
+    _storedPassword = secret;
 
-    return true;
+    // getSSID() copies this out without waiting for the service task
+    portENTER_CRITICAL(&_ssidMux);
+    strlcpy(_ssidSnapshot, ssid.c_str(), sizeof(_ssidSnapshot));
+    portEXIT_CRITICAL(&_ssidMux);
+}
+
+void ESP32ProvisionToolkit::recordConnectResult(bool success) {
+    if (_activeNetwork < 0) {
+        return;
+    }
+
+    StoredNetwork& network = _networks[_activeNetwork];
+    uint8_t history = (network.history << 1) | (success ? 1 : 0);
+    bool changed = history != network.history;
+    network.history = history;
+
+    if (success) {
+        if (network.lastUsed != _networkSequence || _networkSequence == 0) {
+            network.lastUsed = ++_networkSequence;
+            changed = true;
+        }
+
+        // Remember the AP for a directed connect next time
+        const uint8_t* bssid = WiFi.BSSID();
+        uint8_t channel = WiFi.channel();
+        if (_config.fastReconnectEnabled && bssid &&
+            (channel != network.channel || memcmp(bssid, network.bssid, sizeof(network.bssid)) != 0)) {
+            memcpy(network.bssid, bssid, sizeof(network.bssid));
+            network.channel = channel;
+            changed = true;
+
+            log(LOG_DEBUG, "Cached AP %02X:%02X:%02X:%02X:%02X:%02X on channel %u",
+                bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5], channel);
+        }
+    }
+
+    // A stable device (history all ones, same AP) never writes flash here
+    if (changed) {
+        persistNetworks();
+    }
+}
+
+void ESP32ProvisionToolkit::loadLease() {
+    memset(&_cachedLease, 0, sizeof(_cachedLease));
+
+    if (!_preferences.begin(NVS_NAMESPACE, true)) {
+        return;
+    }
+
+    if (_preferences.getBytes(NVS_LEASE, &_cachedLease, sizeof(_cachedLease)) != sizeof(_cachedLease)) {
+        memset(&_cachedLease, 0, sizeof(_cachedLease));
+    }
+
+    _preferences.end();
+}
+
+void ESP32ProvisionToolkit::saveLease() {
+    CachedLease lease;
+    lease.ssidHash = fnv1a(_storedSSID.c_str());
+    lease.ip = (uint32_t)WiFi.localIP();
+    lease.gateway = (uint32_t)WiFi.gatewayIP();
+    lease.subnet = (uint32_t)WiFi.subnetMask();
+    lease.dns1 = (uint32_t)WiFi.dnsIP(0);
+    lease.dns2 = (uint32_t)WiFi.dnsIP(1);
+    lease.obtainedAt = (uint32_t)time(nullptr);
+
+    if (lease.ip == 0) {
+        return;
+    }
+
+    // Avoid a flash write on every wake: only rewrite when the lease changed
+    // or is past half of its allowed age
+    bool sameLease = lease.ssidHash == _cachedLease.ssidHash &&
+                     lease.ip == _cachedLease.ip &&
+                     lease.gateway == _cachedLease.gateway &&
+                     lease.subnet == _cachedLease.subnet &&
+                     lease.dns1 == _cachedLease.dns1 &&
+                     lease.dns2 == _cachedLease.dns2;
+
+    if (sameLease && isCachedLeaseFresh() &&
+        lease.obtainedAt - _cachedLease.obtainedAt < _config.leaseCacheMaxAge / 2) {
+        return;
+    }
+
+    if (!_preferences.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+
+    _preferences.putBytes(NVS_LEASE, &lease, sizeof(lease));
+    _preferences.end();
+
+    _cachedLease = lease;
+
+    log(LOG_DEBUG, "Cached DHCP lease: %s", WiFi.localIP().toString().c_str());
+}
+
+bool ESP32ProvisionToolkit::isCachedLeaseFresh() {
+    if (_cachedLease.ip == 0 || _cachedLease.ssidHash != fnv1a(_storedSSID.c_str())) {
+        return false;
+    }
+
+    // The RTC clock only survives deep sleep and soft resets; after a power
+    // cycle the age of the lease is unknown
+    esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_POWERON || reason == ESP_RST_BROWNOUT) {
+        return false;
+    }
+
+    uint32_t now = (uint32_t)time(nullptr);
+    return now >= _cachedLease.obtainedAt && now - _cachedLease.obtainedAt < _config.leaseCacheMaxAge;
 }
 
 bool ESP32ProvisionToolkit::loadResetPassword() {
@@ -354,9 +1049,14 @@ void ESP32ProvisionToolkit::clearAllCredentials() {
         _preferences.end();
     }
 
-    _storedSSID = "";
-    _storedPassword = "";
+    setCurrentNetwork("", "");
     _resetPassword = "";
+    _networkCount = 0;
+    _activeNetwork = -1;
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+    memset(&_cachedLease, 0, sizeof(_cachedLease));
 }
 
 // ===== State Machine =====
@@ -367,7 +1067,7 @@ void ESP32ProvisionToolkit::handleStateInit() {
 
 void ESP32ProvisionToolkit::handleStateLoadConfig() {
     if (loadCredentials()) {
-        log(LOG_INFO, "Found stored credentials for: %s", _storedSSID.c_str());
+        log(LOG_INFO, "Found %u saved network(s)", _networkCount);
         _retryCount = 0;
         _state = STATE_CONNECTING;
         setLEDPattern(100, 900); // Slow blink
@@ -378,610 +1078,2478 @@ void ESP32ProvisionToolkit::handleStateLoadConfig() {
 }
 
 void ESP32ProvisionToolkit::handleStateConnecting() {
-    if (connectToWiFi()) {
-        log(LOG_INFO, "Connected to WiFi: %s", _storedSSID.c_str());
-        log(LOG_INFO, "IP Address: %s", WiFi.localIP().toString().c_str());
-
-        // Setup mDNS if enabled
-        if (_config.mdnsEnabled) {
-            if (MDNS.begin(_config.mdnsName.c_str())) {
-                log(LOG_INFO, "mDNS responder started: %s.local", _config.mdnsName.c_str());
-            }
+    if (!_connectInProgress) {
+        // Credentials from setCredentials(): one unsaved attempt
+        if (_switchPending) {
+            _activeNetwork = -1;
+            setCurrentNetwork(_switchSSID, _switchPassword);
+            beginConnectAttempt();
+            return;
         }
 
-        _state = STATE_CONNECTED;
-        setLEDPattern(0, 0); // Solid on
-
-        // Start minimal web server if reset is enabled
-        startConnectedWebServer();
+        // New cycle: rank the saved networks (may scan in the background)
+        if (_candidateIndex >= _candidateCount) {
+            if (!rankNetworks(false)) {
+                return;
+            }
 
-        if (_onConnectedCallback) {
-            _onConnectedCallback();
+            if (_candidateCount == 0) {
+                log(LOG_INFO, "No saved network in range");
+                _failureReason = WIFI_REASON_NO_AP_FOUND;
+                handleConnectFailure();
+                return;
+            }
         }
-    } else {
-        _state = STATE_RETRY_WAIT;
-        _lastRetryTime = millis();
+
+        selectNetwork(_candidates[_candidateIndex]);
+        beginConnectAttempt();
+        return;
     }
-}
 
-void ESP32ProvisionToolkit::handleStateConnected() {
-    // Client handling
-    if (_webServer) {
-        _webServer->handleClient();
+    ConnectAttemptStatus status = pollConnectAttempt();
+
+    if (status == CONNECT_PENDING) {
+        return;
     }
 
-    // Check if still connected
-    if (WiFi.status() != WL_CONNECTED) {
-        log(LOG_ERROR, "WiFi connection lost");
-        _retryCount = 0;
-        _state = STATE_CONNECTING;
-        setLEDPattern(100, 900);
-    }
-}
-
-void ESP32ProvisionToolkit::handleStateRetryWait() {
-    if (millis() - _lastRetryTime >= _config.retryDelay) {
-        _retryCount++;
-
-        log(LOG_INFO, "Retry %d/%d", _retryCount, _config.maxRetries);
+    if (status == CONNECT_SUCCEEDED) {
+        if (_switchPending) {
+            _switchPending = false;
+            if (saveCredentials(_switchSSID, _switchPassword)) {
+                log(LOG_INFO, "Switched to %s, credentials saved", _switchSSID.c_str());
+            }
+            _switchPassword = "";
+        }
 
-        if (_retryCount >= _config.maxRetries) {
-            log(LOG_ERROR, "Max retries exceeded");
+        handleConnectSuccess();
+    } else {
+        abortConnectAttempt();
+
+        // Roll back: the saved networks are untouched, reconnect to them
+        if (_switchPending) {
+            _switchPending = false;
+            _switchPassword = "";
+            _lastFailure = _failureReason ? classifyFailure(_failureReason) : FAILURE_TIMEOUT;
+            _handshakeTimeouts = 0;
+            log(LOG_ERROR, "Could not connect to %s (%s), reverting to saved networks",
+                _switchSSID.c_str(), describeFailure(_failureReason, false));
+            _candidateCount = 0;
+            _candidateIndex = 0;
+            _rankReady = false;
+            return;
+        }
 
-            if (_onFailedCallback) {
-                _onFailedCallback(_retryCount);
-            }
+        recordConnectResult(false);
 
-            if (_config.autoWipeOnMaxRetries) {
-                log(LOG_INFO, "Auto-wiping credentials");
-                clearAllCredentials();
-                _state = STATE_PROVISIONING;
-            } else {
-                // Keep retrying
-                _retryCount = 0;
-                _state = STATE_CONNECTING;
-            }
-        } else {
-            _state = STATE_CONNECTING;
+        // Other saved networks are in range: try them before backing off
+        if (++_candidateIndex < _candidateCount) {
+            log(LOG_INFO, "Trying next saved network");
+            return;
         }
-    }
-}
 
-void ESP32ProvisionToolkit::handleStateProvisioning() {
-    startProvisioningMode();
-    _state = STATE_PROVISIONING_ACTIVE;
+        handleConnectFailure();
+    }
 }
 
-void ESP32ProvisionToolkit::handleStateProvisioningActive() {
-    // Handle DNS requests
-    if (_dnsServer) {
-        _dnsServer->processNextRequest();
+void ESP32ProvisionToolkit::handleConnectSuccess() {
+    log(LOG_INFO, "Connected to WiFi: %s", _storedSSID.c_str());
+    log(LOG_INFO, "IP Address: %s", WiFi.localIP().toString().c_str());
+
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+    _skipDirectedConnect = false;
+    recordConnectResult(true);
+
+    _ipEventPending = false;
+    _connectedTime = millis();
+    _retryPolicy->reset();
+    _lastFailure = FAILURE_NONE;
+    _failureReason = 0;
+    _handshakeTimeouts = 0;
+
+    if (_usingCachedLease) {
+        log(LOG_DEBUG, "Using cached lease");
+        _leaseRevalidatePending = _config.leaseRevalidateDelay > 0;
+    } else if (_config.leaseCacheEnabled && !_config.staticIPEnabled) {
+        _skipCachedLease = false;
+        saveLease();
     }
 
-    // Handle web requests
-    if (_webServer) {
-        _webServer->handleClient();
+    // Setup mDNS if enabled
+    if (_config.mdnsEnabled) {
+        if (MDNS.begin(_config.mdnsName.c_str())) {
+            log(LOG_INFO, "mDNS responder started: %s.local", _config.mdnsName.c_str());
+        }
     }
 
-    // Check timeout
-    if (_config.apTimeout > 0 && millis() - _apStartTime >= _config.apTimeout) {
-        log(LOG_INFO, "AP timeout reached");
-        stopProvisioningMode();
+    _state = STATE_CONNECTED;
+    setLEDPattern(0, 0); // Solid on
 
-        // Retry connection if we have credentials
-        if (_storedSSID.length() > 0) {
-            _state = STATE_CONNECTING;
-        }
+    // Start minimal web server if reset is enabled
+    startConnectedWebServer();
+
+    if (_onConnectedCallback) {
+        _onConnectedCallback();
     }
 }
 
-// ===== Connection =====
-
-bool ESP32ProvisionToolkit::connectToWiFi() {
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(_storedSSID.c_str(), _storedPassword.c_str());
+void ESP32ProvisionToolkit::applyReconfigure() {
+    ReconfigureRequest request = _reconfigure;
+    _reconfigure = RECONFIGURE_NONE;
 
-    unsigned long startAttempt = millis();
-    const unsigned long timeout = 10000; // 10 second timeout per attempt
+    // Tear down whatever the current state runs
+    if (_state == STATE_PROVISIONING_ACTIVE) {
+        stopProvisioningMode();
+    } else {
+        stopWebServer();
+    }
 
-    while (WiFi.status() != WL_CONNECTED && millis() - startAttempt < timeout) {
-        delay(100);
+    if (_state == STATE_CONNECTED && _config.mdnsEnabled) {
+        MDNS.end();
     }
 
-    return WiFi.status() == WL_CONNECTED;
-}
+    _connectInProgress = false;
+    _testState = TEST_IDLE;
+    _switchPending = false;
+    _waitingForAP = false;
+    _leaseRevalidatePending = false;
+    _retryCount = 0;
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+    WiFi.disconnect();
+
+    if (request == RECONFIGURE_PROVISION) {
+        log(LOG_INFO, "Entering provisioning mode");
+        _state = STATE_PROVISIONING;
+        return;
+    }
 
-void ESP32ProvisionToolkit::disconnectWiFi() {
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_OFF);
+    _switchPending = request == RECONFIGURE_SWITCH;
+    _state = STATE_CONNECTING;
+    setLEDPattern(100, 900); // Slow blink
 }
 
-// ===== Provisioning =====
+void ESP32ProvisionToolkit::handleConnectFailure() {
+    ConnectFailure previous = _lastFailure;
+    _lastFailure = _failureReason ? classifyFailure(_failureReason) : FAILURE_TIMEOUT;
 
-void ESP32ProvisionToolkit::startProvisioningMode() {
-    log(LOG_INFO, "Starting provisioning mode");
+    if (_lastFailure != FAILURE_TIMEOUT) {
+        log(LOG_ERROR, "Connection failed, reason %u", _failureReason);
+    }
 
-    // Stop any existing connection
-    disconnectWiFi();
+    _state = STATE_RETRY_WAIT;
+    _lastRetryTime = millis();
+    _waitingForAP = false;
 
-    // Stop any existing webserver
-    stopWebServer();
+    switch (_lastFailure) {
+        case FAILURE_AUTH:
+            if (_config.failFastOnAuthError) {
+                // Retrying will not fix a wrong password
+                log(LOG_ERROR, "Authentication failed, entering provisioning mode");
+                notifyFailed();
+                _retryCount = 0;
+                _handshakeTimeouts = 0;
+                _state = STATE_PROVISIONING;
+                return;
+            }
+            break;
 
-    // Create unique AP name
-    String apName = _config.apName + "-" + getMACAddress().substring(9);
-    apName.replace(":", "");
+        case FAILURE_NO_AP:
+            // Scan until the AP is back; each scan round counts as a retry
+            log(LOG_INFO, "Saved networks not found, waiting for one to appear");
+            _waitingForAP = true;
+            _retryDelay = _retryPolicy->nextDelay(_retryCount + 1);
+            return;
 
-    // Start AP
-    WiFi.mode(WIFI_AP);
+        case FAILURE_TRANSIENT:
+            // First hiccup in a row: retry right away
+            if (previous != FAILURE_TRANSIENT) {
+                _retryDelay = _config.transientRetryDelay;
+                log(LOG_DEBUG, "Transient failure, quick retry in %lu ms", _retryDelay);
+                return;
+            }
+            break;
 
-    if (_config.apPassword.length() >= 8) { // Valid password
-        WiFi.softAP(apName.c_str(), _config.apPassword.c_str());
-        log(LOG_INFO, "AP started: %s (password protected)", apName.c_str());
-    } else if (_config.apPassword.length() >= 1) { // Password too short
-        WiFi.softAP(apName.c_str());
-        log(LOG_ERROR,
-            "AP password too short (%d chars). WPA2 requires at least 8. Starting OPEN AP.",
-            _config.apPassword.length());
-    } else { // Open network
-        WiFi.softAP(apName.c_str());
-        log(LOG_INFO, "AP started: %s (open network)", apName.c_str());
+        default:
+            break;
     }
 
-    IPAddress apIP = WiFi.softAPIP();
-    log(LOG_INFO, "AP IP: %s", apIP.toString().c_str());
+    _retryDelay = _retryPolicy->nextDelay(_retryCount + 1);
+    log(LOG_DEBUG, "Next attempt in %lu ms (%s)", _retryDelay, _retryPolicy->name());
+}
 
-    // Start DNS server for captive portal
-    if (!_dnsServer) {
-        _dnsServer = new DNSServer();
+void ESP32ProvisionToolkit::handleStateConnected() {
+    // Client handling (the stock poll sleeps 1 ms even with nothing to serve)
+    if (_webServerListening) {
+        _webServer->poll();
     }
-    _dnsServer->start(DNS_PORT, "*", apIP);
 
-    // Load reset password if needed
-    if (_config.httpResetAuthRequired) {
-        loadResetPassword();
+    // Confirm the cached lease with a real DHCP exchange once the
+    // application had its window on the fast static configuration. The
+    // core can't start DHCP on a configured interface without clearing its
+    // address first, so open sockets drop until the new lease is bound.
+    if (_leaseRevalidatePending && millis() - _connectedTime >= _config.leaseRevalidateDelay) {
+        log(LOG_DEBUG, "Revalidating cached lease via DHCP");
+        _leaseRevalidatePending = false;
+        _usingCachedLease = false;
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());
     }
 
-    // Start web server
-    setupWebServerProvisioningMode();
-
-    _apStartTime = millis();
-    setLEDPattern(100, 100); // Fast blink
+    // New address from DHCP (first lease after revalidation or a renewal)
+    if (_ipEventPending) {
+        _ipEventPending = false;
+        if (_config.leaseCacheEnabled && !_config.staticIPEnabled && !_usingCachedLease) {
+            if ((uint32_t)WiFi.localIP() != _cachedLease.ip) {
+                log(LOG_INFO, "DHCP assigned a new address: %s", WiFi.localIP().toString().c_str());
+            }
+            saveLease();
+        }
+    }
 
-    if (_onAPModeCallback) {
-        _onAPModeCallback(apName.c_str(), apIP.toString().c_str());
+    // Check if still connected
+    if (WiFi.status() != WL_CONNECTED) {
+        log(LOG_ERROR, "WiFi connection lost");
+        _retryCount = 0;
+        _state = STATE_CONNECTING;
+        setLEDPattern(100, 900);
     }
 }
 
-void ESP32ProvisionToolkit::stopProvisioningMode() {
-    log(LOG_INFO, "Stopping provisioning mode");
+void ESP32ProvisionToolkit::handleStateRetryWait() {
+    if (_waitingForAP) {
+        if (millis() - _lastRetryTime < _retryDelay) {
+            return;
+        }
 
-    if (_dnsServer) {
-        _dnsServer->stop();
-    }
+        if (!rankNetworks(true)) {
+            return;
+        }
 
-    stopWebServer();
+        // Every scan round counts as a retry, so a network that is gone for
+        // good (or a hidden SSID that keeps failing) ends in the portal
+        _retryCount++;
 
-    WiFi.softAPdisconnect(true);
-}
+        if (_retryCount >= _config.maxRetries) {
+            _waitingForAP = false;
+            handleRetriesExhausted();
+            return;
+        }
+
+        if (_candidateCount == 0) {
+            _retryDelay = _retryPolicy->nextDelay(_retryCount + 1);
+            _lastRetryTime = millis();
+            log(LOG_DEBUG, "Still no saved network in range (%d/%d), next scan in %lu ms",
+                _retryCount, _config.maxRetries, _retryDelay);
+            return;
+        }
 
-void ESP32ProvisionToolkit::setupWebServerProvisioningMode() {
-    if (!_webServer) {
-        _webServer = new WebServer(WEB_SERVER_PORT);
+        log(LOG_INFO, "Network %s is in range", _networks[_candidates[0]].ssid);
+        _waitingForAP = false;
+        _state = STATE_CONNECTING;
+        return;
     }
 
-    _webServer->on("/", HTTP_GET, staticHandleRoot);
-    _webServer->on("/scan", HTTP_GET, staticHandleScan);
-    _webServer->on("/save", HTTP_POST, staticHandleSave);
+    if (millis() - _lastRetryTime >= _retryDelay) {
+        _retryCount++;
 
-    // This avoid captive portals redirect after form submission
-    _webServer->on("/save", HTTP_GET, staticHandleSaveGet);
+        log(LOG_INFO, "Retry %d/%d", _retryCount, _config.maxRetries);
 
-    if (_config.httpResetEnabled) {
-        _webServer->on("/reset", HTTP_POST, staticHandleReset);
+        if (_retryCount >= _config.maxRetries) {
+            handleRetriesExhausted();
+        } else {
+            _state = STATE_CONNECTING;
+        }
     }
+}
 
-    registerCustomRoutes(ROUTE_PROVISIONING_ONLY);
+void ESP32ProvisionToolkit::handleRetriesExhausted() {
+    log(LOG_ERROR, "Max retries exceeded");
 
-    _webServer->onNotFound(staticHandleNotFound);
+    notifyFailed();
 
-    _webServer->begin();
-    log(LOG_INFO, "Web server started on port %d", WEB_SERVER_PORT);
+    if (_config.autoWipeOnMaxRetries) {
+        log(LOG_INFO, "Auto-wiping credentials");
+        clearAllCredentials();
+        _state = STATE_PROVISIONING;
+    } else {
+        // Keep retrying
+        _retryCount = 0;
+        _state = STATE_CONNECTING;
+    }
 }
 
-// ===== Web Server Handlers =====
+bool ESP32ProvisionToolkit::rankNetworks(bool requireScan) {
+    // A single network needs no ranking: let the driver find it
+    if (!requireScan && _networkCount == 1) {
+        memset(_scanChannel, 0, sizeof(_scanChannel));
+        _candidates[0] = 0;
+        _candidateCount = 1;
+        _candidateIndex = 0;
+        return true;
+    }
 
-void ESP32ProvisionToolkit::handleRoot() {
-    String html = generateHTML();
-    _webServer->send(200, "text/html", html);
+    // Results are ranked by pollScan() as soon as the scan completes
+    if (_rankReady) {
+        _rankReady = false;
+        return true;
+    }
+
+    _rankRequested = true;
+    startScan();
+    return false;
 }
 
-void ESP32ProvisionToolkit::handleScan() {
-    log(LOG_DEBUG, "Scanning for networks...");
+void ESP32ProvisionToolkit::rankScanResults(int16_t n) {
+    // Strongest sighting of each saved network
+    int32_t rssi[MAX_STORED_NETWORKS] = {0};
+    bool hiddenSeen = n < 0; // A failed scan says nothing about presence
+    memset(_scanChannel, 0, sizeof(_scanChannel));
 
-    int n = WiFi.scanNetworks();
-    String json = "[";
+    for (int16_t i = 0; i < n; i++) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.length() == 0) {
+            hiddenSeen = true;
+            continue;
+        }
 
-    for (int i = 0; i < n; i++) {
-        if (i > 0) json += ",";
-        json += "{";
-        json += "\"ssid\":\"" + WiFi.SSID(i) + "\",";
-        json += "\"rssi\":" + String(WiFi.RSSI(i)) + ",";
-        json += "\"secure\":" + String(WiFi.encryptionType(i) != WIFI_AUTH_OPEN ? "true" : "false");
-        json += "}";
+        int8_t index = findNetwork(ssid);
+        if (index >= 0 && (_scanChannel[index] == 0 || WiFi.RSSI(i) > rssi[index])) {
+            rssi[index] = WiFi.RSSI(i);
+            _scanChannel[index] = WiFi.channel(i);
+            memcpy(_scanBSSID[index], WiFi.BSSID(i), sizeof(_scanBSSID[index]));
+        }
     }
 
-    json += "]";
+    // Score: RSSI, +4 dB per success in the last 8 attempts, +10 dB for the
+    // network used last. Networks not seen are only tried if a hidden SSID is
+    // around, after all visible ones.
+    int32_t score[MAX_STORED_NETWORKS];
+    _candidateCount = 0;
+    _candidateIndex = 0;
 
-    WiFi.scanDelete();
+    for (uint8_t i = 0; i < _networkCount; i++) {
+        if (_scanChannel[i] == 0 && !hiddenSeen) {
+            continue;
+        }
 
-    _webServer->send(200, "application/json", json);
-}
+        score[i] = (_scanChannel[i] ? rssi[i] : -1000) + 4 * __builtin_popcount(_networks[i].history);
+        if (_networkSequence > 0 && _networks[i].lastUsed == _networkSequence) {
+            score[i] += 10;
+        }
 
-void ESP32ProvisionToolkit::handleSave() {
-    String ssid = _webServer->arg("ssid");
-    String password = _webServer->arg("password");
-    String resetPwd = _webServer->arg("reset_password");
+        // Insertion sort, at most MAX_STORED_NETWORKS entries
+        uint8_t pos = _candidateCount++;
+        while (pos > 0 && score[_candidates[pos - 1]] < score[i]) {
+            _candidates[pos] = _candidates[pos - 1];
+            pos--;
+        }
+        _candidates[pos] = i;
+    }
 
-    log(LOG_INFO, "Received configuration: SSID=%s", ssid.c_str());
+    log(LOG_DEBUG, "%u of %u saved network(s) are candidates", _candidateCount, _networkCount);
+}
 
-    if (ssid.length() == 0) {
-        _webServer->send(400, "text/plain", "SSID is required");
+void ESP32ProvisionToolkit::startScan() {
+    // Concurrent requests share the scan that is already running
+    if (_scanInProgress) {
         return;
     }
 
-    // Save WiFi credentials
-    if (!saveCredentials(ssid, password)) {
-        _webServer->send(500, "text/plain", "Failed to save credentials");
+    log(LOG_DEBUG, "Starting background scan");
+    WiFi.scanNetworks(true, true);
+    _scanInProgress = true;
+}
+
+void ESP32ProvisionToolkit::pollScan() {
+    int16_t n = WiFi.scanComplete();
+    if (n == WIFI_SCAN_RUNNING) {
         return;
     }
 
-    // Save reset password if authentication is enabled
-    if (_config.httpResetAuthRequired && resetPwd.length() > 0) {
-        saveResetPassword(resetPwd);
+    _scanInProgress = false;
+
+    // A failed scan keeps the previous results
+    if (n >= 0) {
+        cacheScanResults(n);
     }
 
-    _webServer->send(200, "text/plain", "Configuration saved. Rebooting...");
+    if (_rankRequested) {
+        _rankRequested = false;
+        rankScanResults(n);
+        _rankReady = true;
+    }
 
-    log(LOG_INFO, "Configuration saved, rebooting in 2 seconds");
-    delay(2000);
-    ESP.restart();
+    if (n > 0) {
+        WiFi.scanDelete();
+    }
 }
 
-void ESP32ProvisionToolkit::handleSaveGet() {
-    log(LOG_INFO, "Sending saved status to the client");
-    _webServer->send(200, "text/plain", "OK");
-}
+void ESP32ProvisionToolkit::cacheScanResults(int16_t n) {
+    // Merge access points by SSID (mesh networks show up many times),
+    // keeping the strongest, sorted by RSSI and capped at MAX_SCAN_RESULTS
+    _scanResultCount = 0;
 
-void ESP32ProvisionToolkit::handleReset() {
-    if (!_config.httpResetEnabled) {
-        _webServer->send(403, "text/plain", "Reset disabled");
-        return;
-    }
+    for (int16_t i = 0; i < n; i++) {
+        String ssid = WiFi.SSID(i);
+        if (ssid.length() == 0) {
+            continue; // Hidden network
+        }
 
-    // Check authentication if required
-    if (_config.httpResetAuthRequired) {
-        String password = _webServer->arg("password");
+        int8_t rssi = WiFi.RSSI(i);
+        int16_t pos = -1;
 
-        if (password.length() == 0) {
-            _webServer->send(401, "text/plain", "Password required");
-            return;
+        for (uint8_t j = 0; j < _scanResultCount; j++) {
+            if (ssid == _scanResults[j].ssid) {
+                pos = j;
+                break;
+            }
         }
 
-        if (!verifyPassword(password, _resetPassword)) {
-            log(LOG_ERROR, "Reset authentication failed");
-            _webServer->send(401, "text/plain", "Invalid password");
-            return;
+        if (pos >= 0) {
+            if (rssi <= _scanResults[pos].rssi) {
+                continue;
+            }
+        } else if (_scanResultCount < MAX_SCAN_RESULTS) {
+            pos = _scanResultCount++;
+            strlcpy(_scanResults[pos].ssid, ssid.c_str(), sizeof(_scanResults[pos].ssid));
+        } else if (rssi > _scanResults[MAX_SCAN_RESULTS - 1].rssi) {
+            // Full: evict the weakest
+            pos = MAX_SCAN_RESULTS - 1;
+            strlcpy(_scanResults[pos].ssid, ssid.c_str(), sizeof(_scanResults[pos].ssid));
+        } else {
+            continue;
         }
-    }
-
-    log(LOG_INFO, "HTTP reset triggered");
 
-    _webServer->send(200, "text/plain", "Resetting device...");
+        _scanResults[pos].rssi = rssi;
+        _scanResults[pos].channel = WiFi.channel(i);
+        _scanResults[pos].authMode = WiFi.encryptionType(i);
 
-    delay(1000);
-    performReset("HTTP reset");
-}
+        // Move up to keep the list sorted, strongest first
+        while (pos > 0 && _scanResults[pos - 1].rssi < _scanResults[pos].rssi) {
+            ScanResult tmp = _scanResults[pos - 1];
+            _scanResults[pos - 1] = _scanResults[pos];
+            _scanResults[pos] = tmp;
+            pos--;
+        }
+    }
 
-void ESP32ProvisionToolkit::handleNotFound() {
-    log(LOG_DEBUG, "NotFound: %s %s",
-        _webServer->method() == HTTP_GET ? "GET" : "POST",
-        _webServer->uri().c_str());
+    _scanResultsValid = true;
+    _scanCacheTime = millis();
 
-    // Captive portal redirect
-    _webServer->sendHeader("Location", "/", true);
-    _webServer->send(302, "text/plain", "");
+    log(LOG_DEBUG, "Scan complete, %d access point(s), %u network(s)", n, _scanResultCount);
 }
 
-// Static web server handlers
-void ESP32ProvisionToolkit::staticHandleRoot() {
-    if (_instance) _instance->handleRoot();
+void ESP32ProvisionToolkit::notifyFailed() {
+    if (_onFailedCallback) {
+        _onFailedCallback(_retryCount, _failureReason);
+    } else if (_onFailedLegacyCallback) {
+        _onFailedLegacyCallback(_retryCount);
+    }
 }
 
-void ESP32ProvisionToolkit::staticHandleScan() {
-    if (_instance) _instance->handleScan();
+void ESP32ProvisionToolkit::handleStateProvisioning() {
+    startProvisioningMode();
+    _state = STATE_PROVISIONING_ACTIVE;
 }
 
-void ESP32ProvisionToolkit::staticHandleSave() {
-    if (_instance) _instance->handleSave();
-}
+void ESP32ProvisionToolkit::handleStateProvisioningActive() {
+    // Handle DNS and web requests
+    servicePortal();
 
-void ESP32ProvisionToolkit::staticHandleSaveGet() {
-    if (_instance) _instance->handleSaveGet();
-}
+    // Credentials submitted from the portal take over the station
+    if (_testState == TEST_RUNNING || _testState == TEST_SUCCEEDED) {
+        handleCredentialTest();
+        return;
+    }
 
-void ESP32ProvisionToolkit::staticHandleReset() {
-    if (_instance) _instance->handleReset();
-}
+    if (_config.backgroundReconnectEnabled && _networkCount > 0) {
+        handleBackgroundReconnect();
+        if (_state != STATE_PROVISIONING_ACTIVE) {
+            return;
+        }
+    }
 
-void ESP32ProvisionToolkit::staticHandleNotFound() {
-    if (_instance) _instance->handleNotFound();
+    // Check timeout
+    if (_config.apTimeout > 0 && millis() - _apStartTime >= _config.apTimeout) {
+        log(LOG_INFO, "AP timeout reached");
+        if (_connectInProgress) {
+            abortConnectAttempt();
+        }
+        stopProvisioningMode();
+
+        // Retry connection if we have credentials
+        if (_networkCount > 0) {
+            _state = STATE_CONNECTING;
+        }
+    }
 }
 
-// ===== Reset Mechanisms =====
+void ESP32ProvisionToolkit::handleBackgroundReconnect() {
+    if (!_connectInProgress) {
+        if (millis() - _lastBackgroundAttempt < _config.backgroundReconnectInterval) {
+            return;
+        }
 
-void ESP32ProvisionToolkit::checkHardwareReset() {
-    bool buttonState = digitalRead(_config.resetButtonPin);
-    bool isPressed = _config.resetButtonActiveLow ? (buttonState == LOW) : (buttonState == HIGH);
+        // Scans and connects run on the STA side; the portal stays up
+        if (_candidateIndex >= _candidateCount) {
+            if (!rankNetworks(false)) {
+                return;
+            }
 
-    if (isPressed && !_buttonPressed) {
-        // Button just pressed
-        _buttonPressed = true;
-        _buttonPressStart = millis();
-    } else if (isPressed && _buttonPressed) {
-        // Button still pressed, check duration
-        if (millis() - _buttonPressStart >= _config.resetButtonDuration) {
-            log(LOG_INFO, "Hardware reset button held for %lu ms", _config.resetButtonDuration);
-            performReset("Hardware button");
+            if (_candidateCount == 0) {
+                log(LOG_DEBUG, "No saved network in range, next background attempt in %lu ms",
+                    _config.backgroundReconnectInterval);
+                _lastBackgroundAttempt = millis();
+                return;
+            }
         }
-    } else if (!isPressed && _buttonPressed) {
-        // Button released before threshold
-        _buttonPressed = false;
+
+        log(LOG_INFO, "Background reconnect to %s", _networks[_candidates[_candidateIndex]].ssid);
+        selectNetwork(_candidates[_candidateIndex]);
+        beginConnectAttempt();
+        return;
+    }
+
+    ConnectAttemptStatus status = pollConnectAttempt();
+
+    if (status == CONNECT_PENDING) {
+        return;
+    }
+
+    if (status == CONNECT_SUCCEEDED) {
+        // Nobody needs the portal any more
+        stopProvisioningMode();
+        handleConnectSuccess();
+        return;
     }
+
+    // Failures here don't count as retries: the portal is the fallback already
+    abortConnectAttempt();
+    recordConnectResult(false);
+    _candidateIndex++;
+    _lastBackgroundAttempt = millis();
+
+    log(LOG_DEBUG, "Background reconnect failed (reason %u), next attempt in %lu ms",
+        _failureReason, _config.backgroundReconnectInterval);
 }
 
-void ESP32ProvisionToolkit::checkDoubleReboot() {
-    if (!_preferences.begin(NVS_NAMESPACE, false)) {
+void ESP32ProvisionToolkit::handleCredentialTest() {
+    if (_testState == TEST_SUCCEEDED) {
+        // Give the browser time to pick up the result, then switch over
+        if (millis() - _testDoneTime >= CREDENTIAL_TEST_SWITCHOVER_MS) {
+            _testState = TEST_IDLE;
+            stopProvisioningMode();
+            handleConnectSuccess();
+        }
         return;
     }
 
-    uint32_t bootCount = _preferences.getUInt(NVS_BOOT_COUNT, 0);
-    uint32_t lastBootTime = _preferences.getUInt(NVS_BOOT_TIME, 0);
-    uint32_t currentTime = millis();
+    ConnectAttemptStatus status = pollConnectAttempt();
 
-    bootCount++;
-    _preferences.putUInt(NVS_BOOT_COUNT, bootCount);
-    _preferences.putUInt(NVS_BOOT_TIME, currentTime);
+    if (status != CONNECT_PENDING) {
+        finishCredentialTest(status == CONNECT_SUCCEEDED);
+    }
+}
 
-    log(LOG_DEBUG, "Boot count: %u, last boot: %u ms ago", bootCount, currentTime - lastBootTime);
+void ESP32ProvisionToolkit::finishCredentialTest(bool success) {
+    _testDoneTime = millis();
+    _testReason = _failureReason;
+    _testMessage = describeFailure(_testReason, _staConnected);
 
-    // Check if this is a double reboot
-    if (bootCount >= 2 && (currentTime - lastBootTime) < _config.doubleRebootWindow) {
-        log(LOG_INFO, "Double reboot detected, clearing credentials");
-        clearAllCredentials();
-        _preferences.putUInt(NVS_BOOT_COUNT, 0);
+    // Only credentials that actually connected are persisted
+    if (success && saveCredentials(_testSSID, _testPassword)) {
+        if (_config.httpResetAuthRequired && _testResetPassword.length() > 0) {
+            saveResetPassword(_testResetPassword);
+        }
+
+        log(LOG_INFO, "Credentials for %s verified, switching over", _testSSID.c_str());
+        _testState = TEST_SUCCEEDED;
+    } else {
+        if (success) {
+            _testMessage = "Failed to save credentials";
+        }
+        log(LOG_INFO, "Credential test for %s failed: %s", _testSSID.c_str(), _testMessage);
+
+        abortConnectAttempt();
+
+        // Rejected credentials must not linger as the "current" network;
+        // background reconnects select a saved one before each attempt
+        _activeNetwork = -1;
+        setCurrentNetwork("", "");
+
+        // Drop the idle station unless background reconnects use it
+        if (!_config.backgroundReconnectEnabled || _networkCount == 0) {
+            WiFi.mode(WIFI_AP);
+        }
+
+        _testState = TEST_FAILED;
+        _apStartTime = millis(); // The user is still at it: restart the AP timeout
+        _lastBackgroundAttempt = _apStartTime;
     }
 
-    _preferences.end();
+    _testPassword = "";
+    _testResetPassword = "";
+}
 
-    // Schedule boot count reset
-    // This would normally be done with a timer, but we'll handle it in the main loop
+const char* ESP32ProvisionToolkit::describeFailure(uint8_t reason, bool associated) {
+    switch (reason) {
+        case 0:
+            return associated ? "No IP address from the network" : "Timed out";
+
+        case WIFI_REASON_AUTH_FAIL:
+        case WIFI_REASON_MIC_FAILURE:
+        case WIFI_REASON_802_1X_AUTH_FAILED:
+        case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+        case WIFI_REASON_HANDSHAKE_TIMEOUT:
+            return "Wrong password";
+
+        case WIFI_REASON_NO_AP_FOUND:
+            return "Network not found";
+
+        case WIFI_REASON_ASSOC_FAIL:
+        case WIFI_REASON_ASSOC_TOOMANY:
+            return "Network refused the connection";
+
+        default:
+            return "Connection failed";
+    }
 }
 
-void ESP32ProvisionToolkit::performReset(const char* reason) {
-    log(LOG_INFO, "Performing reset: %s", reason);
+// ===== Connection =====
 
-    if (_onResetCallback) {
-        _onResetCallback();
+void ESP32ProvisionToolkit::beginConnectAttempt() {
+    log(LOG_DEBUG, "Connecting to %s...", _storedSSID.c_str());
+
+    _staConnected = false;
+    _staGotIP = false;
+    _ipEventPending = false;
+    _staDisconnected = false;
+    _lastDisconnectReason = 0;
+
+    // Keep the portal's AP running during background attempts
+    WiFi.mode(_state == STATE_PROVISIONING_ACTIVE ? WIFI_AP_STA : WIFI_STA);
+    WiFi.setAutoReconnect(false); // Retries are owned by the state machine
+    applyIPConfig();
+
+    _directedAttempt = false;
+
+    if (_activeNetwork < 0) {
+        // Unsaved credentials under test from the portal
+        WiFi.begin(_storedSSID.c_str(), _storedPassword.c_str());
+    } else if (_scanChannel[_activeNetwork] > 0) {
+        // Strongest AP from this cycle's ranking scan
+        log(LOG_DEBUG, "Connecting to scanned AP on channel %u", _scanChannel[_activeNetwork]);
+        WiFi.begin(_storedSSID.c_str(), _storedPassword.c_str(),
+                   _scanChannel[_activeNetwork], _scanBSSID[_activeNetwork]);
+    } else if (_config.fastReconnectEnabled && _networks[_activeNetwork].channel > 0 && !_skipDirectedConnect) {
+        // Skip the full-band scan: associate straight to the last known AP
+        const StoredNetwork& network = _networks[_activeNetwork];
+        log(LOG_DEBUG, "Directed connect on channel %u", network.channel);
+        WiFi.begin(_storedSSID.c_str(), _storedPassword.c_str(), network.channel, network.bssid);
+        _directedAttempt = true;
+    } else {
+        WiFi.begin(_storedSSID.c_str(), _storedPassword.c_str());
     }
 
-    clearAllCredentials();
-    delay(500);
-    ESP.restart();
+    _connectStartTime = millis();
+    _connectInProgress = true;
 }
 
-// ===== Web server controls =====
+ESP32ProvisionToolkit::ConnectAttemptStatus ESP32ProvisionToolkit::pollConnectAttempt() {
+    if (_staGotIP) {
+        _connectInProgress = false;
+        return CONNECT_SUCCEEDED;
+    }
 
-void ESP32ProvisionToolkit::startConnectedWebServer() {
-    bool hasCustomRoutes = hasConnectedOnlyRoutes();
+    if (_staDisconnected) {
+        // Leftover from our own disconnect() before this attempt
+        if (_lastDisconnectReason == WIFI_REASON_ASSOC_LEAVE) {
+            _staDisconnected = false;
+            return CONNECT_PENDING;
+        }
 
-    // Only start if software reset is enabled
-    if (!_config.httpResetEnabled && !hasCustomRoutes) {
-        log(LOG_DEBUG, "HTTP reset disabled and no custom routes provided, not starting connected web server");
+        _failureReason = _lastDisconnectReason;
+        _connectInProgress = false;
+        return CONNECT_FAILED;
+    }
+
+    if (millis() - _connectStartTime >= _config.connectTimeout) {
+        _failureReason = 0;
+        log(LOG_ERROR, "Connection attempt timed out after %lu ms%s", _config.connectTimeout,
+            _staConnected ? " (associated, no IP)" : "");
+        _connectInProgress = false;
+        return CONNECT_FAILED;
+    }
+
+    return CONNECT_PENDING;
+}
+
+void ESP32ProvisionToolkit::abortConnectAttempt() {
+    // The AP may have moved or changed channel: fall back to a full scan
+    if (_directedAttempt) {
+        log(LOG_DEBUG, "Directed connect failed, next attempt will scan");
+        _skipDirectedConnect = true;
+    }
+
+    if (_usingCachedLease) {
+        log(LOG_DEBUG, "Connect with cached lease failed, next attempt will use DHCP");
+        _skipCachedLease = true;
+    }
+
+    _connectInProgress = false;
+    WiFi.disconnect();
+}
+
+void ESP32ProvisionToolkit::applyIPConfig() {
+    _usingCachedLease = false;
+    _leaseRevalidatePending = false;
+
+    if (_config.staticIPEnabled) {
+        WiFi.config(_config.staticIP, _config.staticGateway, _config.staticSubnet,
+                    _config.staticDNS1, _config.staticDNS2);
         return;
     }
 
-    if (_webServer) {
-        return; // Already running
+    if (_config.leaseCacheEnabled && !_skipCachedLease && isCachedLeaseFresh()) {
+        // Skip DISCOVER/OFFER/REQUEST/ACK by reusing the last lease
+        WiFi.config(IPAddress(_cachedLease.ip), IPAddress(_cachedLease.gateway),
+                    IPAddress(_cachedLease.subnet), IPAddress(_cachedLease.dns1),
+                    IPAddress(_cachedLease.dns2));
+        _usingCachedLease = true;
+        return;
+    }
+
+    // Make sure a previous static configuration doesn't stick
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+}
+
+void ESP32ProvisionToolkit::disconnectWiFi() {
+    _connectInProgress = false;
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+}
+
+ConnectFailure ESP32ProvisionToolkit::classifyFailure(uint8_t reason) {
+    if (reason != WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT && reason != WIFI_REASON_HANDSHAKE_TIMEOUT) {
+        _handshakeTimeouts = 0;
+    }
+
+    switch (reason) {
+        case WIFI_REASON_AUTH_FAIL:
+        case WIFI_REASON_MIC_FAILURE:
+        case WIFI_REASON_802_1X_AUTH_FAILED:
+            return FAILURE_AUTH;
+
+        case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+        case WIFI_REASON_HANDSHAKE_TIMEOUT:
+            // Usually a wrong password, but a weak link can cause it too
+            if (++_handshakeTimeouts >= HANDSHAKE_TIMEOUT_AUTH_LIMIT) {
+                return FAILURE_AUTH;
+            }
+            return FAILURE_TRANSIENT;
+
+        case WIFI_REASON_NO_AP_FOUND:
+            return FAILURE_NO_AP;
+
+        default:
+            return FAILURE_TRANSIENT;
+    }
+}
+
+void ESP32ProvisionToolkit::handleWiFiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+    // Runs on the WiFi event task: only record what happened, the state
+    // machine picks it up on the next loop()
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+            _staConnected = true;
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            _staGotIP = true;
+            _ipEventPending = true;
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            _staConnected = false;
+            _staGotIP = false;
+            _lastDisconnectReason = info.wifi_sta_disconnected.reason;
+            _staDisconnected = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ===== Provisioning =====
+
+void ESP32ProvisionToolkit::startProvisioningMode() {
+    log(LOG_INFO, "Starting provisioning mode");
+
+    // Stop any existing connection
+    disconnectWiFi();
+
+    // Stop any existing webserver
+    stopWebServer();
+
+    // Create unique AP name
+    String apName = _config.apName + "-" + getMACAddress().substring(9);
+    apName.replace(":", "");
+
+    // Start AP, with the station side available for background reconnects
+    bool backgroundReconnect = _config.backgroundReconnectEnabled && _networkCount > 0;
+    WiFi.mode(backgroundReconnect ? WIFI_AP_STA : WIFI_AP);
+
+    if (_config.apPassword.length() >= 8) { // Valid password
+        WiFi.softAP(apName.c_str(), _config.apPassword.c_str());
+        log(LOG_INFO, "AP started: %s (password protected)", apName.c_str());
+    } else if (_config.apPassword.length() >= 1) { // Password too short
+        WiFi.softAP(apName.c_str());
+        log(LOG_ERROR,
+            "AP password too short (%d chars). WPA2 requires at least 8. Starting OPEN AP.",
+            _config.apPassword.length());
+    } else { // Open network
+        WiFi.softAP(apName.c_str());
+        log(LOG_INFO, "AP started: %s (open network)", apName.c_str());
+    }
+
+    IPAddress apIP = WiFi.softAPIP();
+    log(LOG_INFO, "AP IP: %s", apIP.toString().c_str());
+
+    // Start DNS server for captive portal
+    if (_config.fastDNSEnabled) {
+        if (!_fastDNS) {
+            _fastDNS = new CaptiveDNSServer();
+        }
+        if (!_fastDNS->start(DNS_PORT, apIP)) {
+            log(LOG_ERROR, "Failed to start DNS responder");
+        }
+    } else {
+        if (!_dnsServer) {
+            _dnsServer = new DNSServer();
+        }
+        _dnsServer->start(DNS_PORT, "*", apIP);
     }
 
+    // Probe answers and redirects point at the portal's address directly
+    snprintf(_portalURL, sizeof(_portalURL), "http://%s/", apIP.toString().c_str());
+    _probedOS = 0;
+
     // Load reset password if needed
     if (_config.httpResetAuthRequired) {
         loadResetPassword();
     }
 
-    _webServer = new WebServer(WEB_SERVER_PORT);
-
-    log(LOG_DEBUG, "Starting HTTP server for ConnectedMode...");
+    // Start web server
+    startWebServer(ROUTE_PROVISIONING_ONLY);
+
+    _apStartTime = millis();
+    _lastBackgroundAttempt = _apStartTime;
+    _candidateCount = 0;
+    _candidateIndex = 0;
+    _rankReady = false;
+    setLEDPattern(100, 100); // Fast blink
+
+    // Warm the scan cache before the first client loads the page
+    startScan();
+
+    if (_onAPModeCallback) {
+        _onAPModeCallback(apName.c_str(), apIP.toString().c_str());
+    }
+}
+
+void ESP32ProvisionToolkit::stopProvisioningMode() {
+    log(LOG_INFO, "Stopping provisioning mode");
+
+    if (_dnsServer) {
+        _dnsServer->stop();
+    }
+
+    if (_fastDNS) {
+        const DNSStats& stats = _fastDNS->getStats();
+        log(LOG_DEBUG, "DNS queries: %u A, %u AAAA, %u HTTPS, %u other, %u dropped",
+            stats.a, stats.aaaa, stats.https, stats.other, stats.dropped);
+        _fastDNS->stop();
+    }
+
+    stopWebServer();
+
+    // Results will be stale by the time the portal opens again
+    _scanResultsValid = false;
+    _scanResultCount = 0;
+
+    WiFi.softAPdisconnect(true);
+}
+
+void ESP32ProvisionToolkit::servicePortal() {
+    unsigned long start = millis();
+
+    while (true) {
+        if (_fastDNS) {
+            _fastDNS->processRequests();
+        } else if (_dnsServer) {
+            _dnsServer->processNextRequest();
+        }
+
+        if (_webServer) {
+            _webServer->poll();
+        }
+
+        // The service task waits between iterations instead, without its lock
+        unsigned long elapsed = millis() - start;
+        if (_serviceTask || elapsed >= _config.portalPollBudget) {
+            break;
+        }
+
+        int fds[HTTP_MAX_CLIENTS + 1];
+        size_t count = portalPollFds(fds);
+        uint32_t wait = _config.portalPollBudget - elapsed;
+        waitForSockets(fds, count, wait < PORTAL_POLL_SLICE_MS ? wait : PORTAL_POLL_SLICE_MS);
+    }
+}
+
+size_t ESP32ProvisionToolkit::portalPollFds(int* fds) const {
+    // The DNS socket (with setFastDNS()) and open HTTP client connections.
+    // WiFiServer keeps its listening socket private, so new connections and
+    // the Arduino DNSServer are picked up when the wait times out.
+    size_t count = 0;
+    if (_fastDNS && _fastDNS->fd() >= 0) {
+        fds[count++] = _fastDNS->fd();
+    }
+    if (_webServer) {
+        count += _webServer->pollFds(fds + count, HTTP_MAX_CLIENTS);
+    }
+    return count;
+}
+
+void ESP32ProvisionToolkit::waitForSockets(const int* fds, size_t count, uint32_t timeoutMs) {
+    // Sleeps until one of the sockets has data, or the timeout
+    fd_set readable;
+    FD_ZERO(&readable);
+    int maxFd = -1;
+    for (size_t i = 0; i < count; i++) {
+        FD_SET(fds[i], &readable);
+        if (fds[i] > maxFd) maxFd = fds[i];
+    }
+
+    if (maxFd < 0) {
+        delay(timeoutMs);
+    } else {
+        struct timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        select(maxFd + 1, &readable, nullptr, nullptr, &timeout);
+    }
+}
+
+// ===== Web Server Handlers =====
+
+void ESP32ProvisionToolkit::handleRoot() {
+    // The page is small and revalidated; the assets it links are immutable
+    if (_config.httpResetAuthRequired) {
+        sendAsset("text/html", PORTAL_HTML_RESET_GZ, PORTAL_HTML_RESET_GZ_LEN, PORTAL_HTML_RESET_SIZE,
+                  PORTAL_HTML_RESET_HASH, "no-cache");
+    } else {
+        sendAsset("text/html", PORTAL_HTML_GZ, PORTAL_HTML_GZ_LEN, PORTAL_HTML_SIZE,
+                  PORTAL_HTML_HASH, "no-cache");
+    }
+}
+
+void ESP32ProvisionToolkit::handleStylesheet() {
+    sendAsset("text/css", PORTAL_CSS_GZ, PORTAL_CSS_GZ_LEN, PORTAL_CSS_SIZE,
+              PORTAL_CSS_HASH, "public, max-age=31536000, immutable");
+}
+
+void ESP32ProvisionToolkit::handleScript() {
+    sendAsset("application/javascript", PORTAL_JS_GZ, PORTAL_JS_GZ_LEN, PORTAL_JS_SIZE,
+              PORTAL_JS_HASH, "public, max-age=31536000, immutable");
+}
+
+void ESP32ProvisionToolkit::handleTheme() {
+    // Every device answers on the same portal address: revalidate so one
+    // device's theme never sticks to another's portal
+    char etag[12];
+    snprintf(etag, sizeof(etag), "\"%08lx\"", (unsigned long)_themeHash);
+
+    _webServer->sendHeader("ETag", etag);
+    _webServer->sendHeader("Cache-Control", "no-cache");
+
+    if (isNotModified(etag)) {
+        _webServer->send(304);
+        return;
+    }
+
+    const char* css = _config.portalStylesheet ? _config.portalStylesheet : "";
+    _webServer->send_P(200, "text/css", css, strlen(css));
+}
+
+// If-None-Match: "*" or a comma-separated list of entity-tags, compared
+// exactly but weakly (a W/ prefix doesn't matter)
+static bool etagListMatches(const char* list, const char* etag) {
+    size_t etagLength = strlen(etag);
+    const char* p = list;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == ',') {
+            p++;
+        }
+        if (*p == '\0') {
+            return false;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        if (p[0] == 'W' && p[1] == '/') {
+            p += 2;
+        }
+
+        // Quoted tags may contain commas: find the closing quote first
+        if (*p == '"') {
+            const char* close = strchr(p + 1, '"');
+            if (!close) {
+                return false;
+            }
+            size_t length = close + 1 - p;
+            if (length == etagLength && memcmp(p, etag, length) == 0) {
+                return true;
+            }
+            p = close + 1;
+        }
+
+        // Skip the rest of this element (malformed ones entirely)
+        while (*p != '\0' && *p != ',') {
+            p++;
+        }
+    }
+}
+
+#ifdef PORTAL_IDENTITY_FALLBACK
+static_assert((PORTAL_GZ_WINDOW & (PORTAL_GZ_WINDOW - 1)) == 0, "PORTAL_GZ_WINDOW must be a power of two");
+
+// Inflater state plus a ring the size of the assets' deflate window: the
+// decompressor never looks further back, so the page is never held whole
+struct PortalInflater {
+    tinfl_decompressor state;
+    uint8_t window[PORTAL_GZ_WINDOW];
+};
+
+// Streams the uncompressed asset, one ring's worth of output at a time
+static bool sendInflated(WebServer& server, const char* contentType,
+                         const uint8_t* gz, size_t gzLength, size_t size) {
+    PortalInflater* inflater = new (std::nothrow) PortalInflater;
+    if (!inflater) {
+        server.send(503, "text/plain", "Out of memory");
+        return false;
+    }
+    tinfl_init(&inflater->state);
+
+    server.setContentLength(size);
+    server.send(200, contentType, "");
+
+    // Skip the 10-byte gzip header and 8-byte trailer: raw deflate
+    const uint8_t* in = gz + 10;
+    size_t inLeft = gzLength - 18;
+    size_t ringPos = 0;
+    size_t sent = 0;
+    tinfl_status status;
+
+    do {
+        size_t inBytes = inLeft;
+        size_t outBytes = PORTAL_GZ_WINDOW - ringPos;
+        status = tinfl_decompress(&inflater->state, in, &inBytes, inflater->window,
+                                  inflater->window + ringPos, &outBytes, 0);
+        in += inBytes;
+        inLeft -= inBytes;
+
+        if (outBytes > 0) {
+            server.sendContent((const char*)inflater->window + ringPos, outBytes);
+            ringPos = (ringPos + outBytes) & (PORTAL_GZ_WINDOW - 1);
+            sent += outBytes;
+        }
+    } while (status > TINFL_STATUS_DONE);
+
+    delete inflater;
+    return status == TINFL_STATUS_DONE && sent == size;
+}
+#endif
+
+void ESP32ProvisionToolkit::sendAsset(const char* contentType, const uint8_t* gz, size_t gzLength, size_t size,
+                                      const char* hash, const char* cacheControl) {
+    bool gzip = _webServer->header("Accept-Encoding").indexOf("gzip") >= 0;
+
+    // Each encoding is a separate representation with its own strong ETag
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%s%s\"", hash, gzip ? "-gz" : "");
+
+    _webServer->sendHeader("Vary", "Accept-Encoding");
+    _webServer->sendHeader("ETag", etag);
+    _webServer->sendHeader("Cache-Control", cacheControl);
+
+    if (isNotModified(etag)) {
+        _webServer->send(304);
+        return;
+    }
+
+    if (!gzip) {
+#ifdef PORTAL_IDENTITY_FALLBACK
+        if (!sendInflated(*_webServer, contentType, gz, gzLength, size)) {
+            log(LOG_ERROR, "Failed to inflate portal asset");
+        }
+#else
+        (void)size;
+        _webServer->send(406, "text/plain", "gzip encoding required");
+#endif
+        return;
+    }
+
+    // Straight from flash, with a precomputed Content-Length
+    _webServer->sendHeader("Content-Encoding", "gzip");
+    _webServer->send_P(200, contentType, (const char*)gz, gzLength);
+}
+
+bool ESP32ProvisionToolkit::isNotModified(const char* etag) {
+    String match = _webServer->header("If-None-Match");
+    return etagListMatches(match.c_str(), etag);
+}
+
+void ESP32ProvisionToolkit::handleScan() {
+    // Refresh stale results in the background; the radio is left alone
+    // while a connection attempt needs it
+    bool stale = !_scanResultsValid || millis() - _scanCacheTime >= _config.scanCacheTTL;
+    if (stale && !_connectInProgress) {
+        startScan();
+    }
+
+    JsonStreamWriter json(*_webServer);
+
+    // Nothing to show yet: the page polls again shortly
+    if (!_scanResultsValid) {
+        json.begin(202);
+        json.beginArray().endArray();
+        json.end();
+        return;
+    }
+
+    json.begin();
+    json.beginArray();
+
+    for (uint8_t i = 0; i < _scanResultCount; i++) {
+        const ScanResult& result = _scanResults[i];
+        json.beginObject()
+            .field("ssid", result.ssid)
+            .field("rssi", result.rssi)
+            .field("channel", result.channel)
+            .field("auth", result.authMode)
+            .field("secure", result.authMode != WIFI_AUTH_OPEN)
+            .endObject();
+    }
+
+    json.endArray();
+    json.end();
+}
+
+void ESP32ProvisionToolkit::handleSave() {
+    String ssid = _webServer->arg("ssid");
+    String password = _webServer->arg("password");
+    String resetPwd = _webServer->arg("reset_password");
+
+    log(LOG_INFO, "Received configuration: SSID=%s", ssid.c_str());
+
+    if (ssid.length() == 0) {
+        _webServer->send(400, "text/plain", "SSID is required");
+        return;
+    }
+
+    if (ssid.length() > 32) {
+        _webServer->send(400, "text/plain", "SSID must be at most 32 characters");
+        return;
+    }
+
+    if (password.length() > 0 && (password.length() < 8 || password.length() > 64)) {
+        _webServer->send(400, "text/plain", "Password must be 8 to 64 characters");
+        return;
+    }
+
+    if (_testState == TEST_RUNNING || _testState == TEST_SUCCEEDED) {
+        _webServer->send(409, "text/plain", "A connection test is already running");
+        return;
+    }
+
+    // A background reconnect would compete for the station
+    if (_connectInProgress) {
+        abortConnectAttempt();
+    }
+
+    // Try the credentials first; they are saved only if they work
+    _testSSID = ssid;
+    _testPassword = password;
+    _testResetPassword = resetPwd;
+    _testReason = 0;
+    _testState = TEST_RUNNING;
+
+    _activeNetwork = -1;
+    setCurrentNetwork(ssid, password);
+    beginConnectAttempt();
+
+    log(LOG_INFO, "Testing credentials for %s", ssid.c_str());
+    _webServer->send(202, "text/plain", "Testing connection...");
+}
+
+void ESP32ProvisionToolkit::handleStatus() {
+    JsonStreamWriter json(*_webServer);
+    json.begin();
+    json.beginObject();
+
+    switch (_testState) {
+        case TEST_RUNNING:
+            json.field("state", "testing");
+            json.field("step", _staConnected ? "obtaining_ip" : "associating");
+            break;
+
+        case TEST_SUCCEEDED:
+            json.field("state", "connected");
+            json.field("ip", WiFi.localIP().toString());
+            break;
+
+        case TEST_FAILED:
+            json.field("state", "failed");
+            json.field("reason", _testReason);
+            json.field("message", _testMessage);
+            break;
+
+        default:
+            json.field("state", "idle");
+            break;
+    }
+
+    json.endObject();
+    json.end();
+}
+
+void ESP32ProvisionToolkit::handleSaveGet() {
+    log(LOG_INFO, "Sending saved status to the client");
+    _webServer->send(200, "text/plain", "OK");
+}
+
+void ESP32ProvisionToolkit::handleNetworks() {
+    JsonStreamWriter json(*_webServer);
+    json.begin();
+    json.beginArray();
+
+    for (uint8_t i = 0; i < _networkCount; i++) {
+        json.beginObject()
+            .field("ssid", _networks[i].ssid)
+            .field("successes", __builtin_popcount(_networks[i].history))
+            .endObject();
+    }
+
+    json.endArray();
+    json.end();
+}
+
+void ESP32ProvisionToolkit::handleRemoveNetwork() {
+    String ssid = _webServer->arg("ssid");
+
+    if (!removeNetwork(ssid)) {
+        _webServer->send(404, "text/plain", "Network not found");
+        return;
+    }
+
+    _webServer->send(200, "text/plain", "OK");
+}
+
+void ESP32ProvisionToolkit::handleReset() {
+    if (!_config.httpResetEnabled) {
+        _webServer->send(403, "text/plain", "Reset disabled");
+        return;
+    }
+
+    // Check authentication if required
+    if (_config.httpResetAuthRequired) {
+        String password = _webServer->arg("password");
+
+        if (password.length() == 0) {
+            _webServer->send(401, "text/plain", "Password required");
+            return;
+        }
+
+        if (!verifyPassword(password, _resetPassword)) {
+            log(LOG_ERROR, "Reset authentication failed");
+            _webServer->send(401, "text/plain", "Invalid password");
+            return;
+        }
+    }
+
+    log(LOG_INFO, "HTTP reset triggered");
+
+    _webServer->send(200, "text/plain", "Resetting device...");
+
+    delay(1000);
+    performReset("HTTP reset");
+}
+
+void ESP32ProvisionToolkit::handleNotFound() {
+    log(LOG_DEBUG, "NotFound: %s %s",
+        _webServer->method() == HTTP_GET ? "GET" : "POST",
+        _webServer->uri().c_str());
+
+    if (_webServer->scope() == ROUTE_CONNECTED_ONLY) {
+        _webServer->send(404, "text/plain", "Not found");
+        return;
+    }
+
+    // Captive portal redirect
+    _webServer->sendHeader("Location", _portalURL, true);
+    _webServer->send(302, "text/plain", "");
+}
+
+void ESP32ProvisionToolkit::handleCaptiveProbe(size_t index) {
+    const CaptiveProbe& probe = CAPTIVE_PROBES[index];
+
+    // Phones repeat their probe every few seconds: report each OS once
+    uint8_t bit = 1 << probe.os;
+    log((_probedOS & bit) ? LOG_DEBUG : LOG_INFO, "Captive portal probe from %s client (%s)",
+        PROBE_OS_NAMES[probe.os], probe.path);
+    _probedOS |= bit;
+
+    _webServer->sendHeader("Location", _portalURL);
+    _webServer->sendHeader("Cache-Control", "no-store");
+    _webServer->send(302, "text/plain", "");
+}
+
+// Static web server handlers
+void ESP32ProvisionToolkit::staticHandleRoot() {
+    if (_instance) _instance->handleRoot();
+}
+
+void ESP32ProvisionToolkit::staticHandleStylesheet() {
+    if (_instance) _instance->handleStylesheet();
+}
+
+void ESP32ProvisionToolkit::staticHandleScript() {
+    if (_instance) _instance->handleScript();
+}
+
+void ESP32ProvisionToolkit::staticHandleTheme() {
+    if (_instance) _instance->handleTheme();
+}
+
+void ESP32ProvisionToolkit::staticHandleScan() {
+    if (_instance) _instance->handleScan();
+}
+
+void ESP32ProvisionToolkit::staticHandleSave() {
+    if (_instance) _instance->handleSave();
+}
+
+void ESP32ProvisionToolkit::staticHandleSaveGet() {
+    if (_instance) _instance->handleSaveGet();
+}
+
+void ESP32ProvisionToolkit::staticHandleStatus() {
+    if (_instance) _instance->handleStatus();
+}
+
+void ESP32ProvisionToolkit::staticHandleNetworks() {
+    if (_instance) _instance->handleNetworks();
+}
+
+void ESP32ProvisionToolkit::staticHandleRemoveNetwork() {
+    if (_instance) _instance->handleRemoveNetwork();
+}
+
+void ESP32ProvisionToolkit::staticHandleReset() {
+    if (_instance) _instance->handleReset();
+}
+
+void ESP32ProvisionToolkit::staticHandleNotFound() {
+    if (_instance) _instance->handleNotFound();
+}
+
+// ===== Reset Mechanisms =====
+
+void ESP32ProvisionToolkit::checkHardwareReset() {
+    bool buttonState = digitalRead(_config.resetButtonPin);
+    bool isPressed = _config.resetButtonActiveLow ? (buttonState == LOW) : (buttonState == HIGH);
+
+    if (isPressed && !_buttonPressed) {
+        // Button just pressed
+        _buttonPressed = true;
+        _buttonPressStart = millis();
+    } else if (isPressed && _buttonPressed) {
+        // Button still pressed, check duration
+        if (millis() - _buttonPressStart >= _config.resetButtonDuration) {
+            log(LOG_INFO, "Hardware reset button held for %lu ms", _config.resetButtonDuration);
+            performReset("Hardware button");
+        }
+    } else if (!isPressed && _buttonPressed) {
+        // Button released before threshold
+        _buttonPressed = false;
+    }
+}
+
+void ESP32ProvisionToolkit::checkDoubleReboot() {
+    if (!_preferences.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+
+    uint32_t bootCount = _preferences.getUInt(NVS_BOOT_COUNT, 0);
+    uint32_t lastBootTime = _preferences.getUInt(NVS_BOOT_TIME, 0);
+    uint32_t currentTime = millis();
+
+    bootCount++;
+    _preferences.putUInt(NVS_BOOT_COUNT, bootCount);
+    _preferences.putUInt(NVS_BOOT_TIME, currentTime);
+
+    log(LOG_DEBUG, "Boot count: %u, last boot: %u ms ago", bootCount, currentTime - lastBootTime);
+
+    // Check if this is a double reboot
+    if (bootCount >= 2 && (currentTime - lastBootTime) < _config.doubleRebootWindow) {
+        log(LOG_INFO, "Double reboot detected, clearing credentials");
+        clearAllCredentials();
+        _preferences.putUInt(NVS_BOOT_COUNT, 0);
+    }
+
+    _preferences.end();
+
+    // Schedule boot count reset
+    // This would normally be done with a timer, but we'll handle it in the main loop
+}
+
+void ESP32ProvisionToolkit::performReset(const char* reason) {
+    log(LOG_INFO, "Performing reset: %s", reason);
+
+    if (_onResetCallback) {
+        _onResetCallback();
+    }
+
+    clearAllCredentials();
+    delay(500);
+    ESP.restart();
+}
+
+// ===== Web server controls =====
+
+void ESP32ProvisionToolkit::startConnectedWebServer() {
+    bool hasCustomRoutes = false;
+    for (const auto& route : _customRoutes) {
+        if (route.scope != ROUTE_PROVISIONING_ONLY) {
+            hasCustomRoutes = true;
+            break;
+        }
+    }
+
+    // Only start if software reset is enabled
+    if (!_config.httpResetEnabled && !hasCustomRoutes) {
+        log(LOG_DEBUG, "HTTP reset disabled and no custom routes provided, not starting connected web server");
+        return;
+    }
+
+    // Load reset password if needed
+    if (_config.httpResetAuthRequired) {
+        loadResetPassword();
+    }
+
+    startWebServer(ROUTE_CONNECTED_ONLY);
+}
+
+// Every route of the web server, in one request handler. Paths are stored
+// once in a string pool; exact paths are found through a hash table,
+// paths with {param} segments by matching them segment by segment, and the
+// parameter values are returned by WebServer::pathArg(). Only routes of the
+// server's current scope match. Exact paths win over patterns; otherwise
+// regular routes win over fallback ones, then the one registered first.
+// Upload and raw-body callbacks aren't forwarded: the toolkit has no way to
+// register them, so WebServer reads bodies into args ("plain") instead.
+class RouteDispatcher : public RequestHandler {
+public:
+    explicit RouteDispatcher(const WebServerBackend& server) : _server(server), _matched(NO_ROUTE) {
+        for (uint16_t& bucket : _buckets) {
+            bucket = NO_ROUTE;
+        }
+    }
+
+    void add(const char* path, HTTPMethod method, HttpRouteScope scope, WebServer::THandlerFunction handler,
+             bool fallback) {
+        Route route;
+        route.hash = fnv1a(path);
+        route.path = intern(path, route.hash);
+        route.next = NO_ROUTE;
+        route.method = method;
+        route.scope = scope;
+        route.pattern = strchr(path, '{') != nullptr;
+        route.fallback = fallback;
+
+        uint16_t index = _routes.size();
+        _routes.push_back(route);
+        _handlers.push_back(handler);
+
+        // Earlier registrations keep precedence, but regular routes go
+        // ahead of every fallback one, even when added later
+        if (route.pattern) {
+            auto at = _patterns.begin();
+            while (at != _patterns.end() && (fallback || !_routes[*at].fallback)) {
+                ++at;
+            }
+            _patterns.insert(at, index);
+            return;
+        }
+
+        uint16_t* link = &_buckets[route.hash & (ROUTE_HASH_BUCKETS - 1)];
+        while (*link != NO_ROUTE && (fallback || !_routes[*link].fallback)) {
+            link = &_routes[*link].next;
+        }
+        _routes[index].next = *link;
+        *link = index;
+    }
+
+    // WebServer asks canHandle() and then, for the same request, handle():
+    // the match (and its path arguments) is kept for the second call
+    bool canHandle(HTTPMethod method, RequestUri uri) override {
+        _matched = find(method, uri.c_str());
+        return _matched != NO_ROUTE;
+    }
+
+#ifdef REQUEST_HANDLER_SERVER_ARG
+    bool canHandle(WebServer& server, HTTPMethod method, RequestUri uri) override {
+        return canHandle(method, uri);
+    }
+#endif
+
+    bool handle(WebServer& server, HTTPMethod method, RequestUri uri) override {
+        uint16_t index = _matched != NO_ROUTE ? _matched : find(method, uri.c_str());
+        _matched = NO_ROUTE;
+        if (index == NO_ROUTE) {
+            return false;
+        }
+        _handlers[index]();
+        return true;
+    }
+
+private:
+    static const uint16_t NO_ROUTE = 0xFFFF;
+
+    struct Route {
+        uint32_t hash;    // FNV-1a of the path
+        uint16_t path;    // Offset in _paths
+        uint16_t next;    // Next exact route in the same bucket
+        uint8_t method;
+        uint8_t scope;
+        bool pattern;     // Has {param} segments
+        bool fallback;    // Built-in default a custom route may override
+    };
+
+    uint16_t intern(const char* path, uint32_t hash) {
+        for (const Route& route : _routes) {
+            if (route.hash == hash && strcmp(&_paths[route.path], path) == 0) {
+                return route.path;
+            }
+        }
+
+        uint16_t offset = _paths.size();
+        _paths.insert(_paths.end(), path, path + strlen(path) + 1);
+        return offset;
+    }
+
+    bool accepts(const Route& route, HTTPMethod method) const {
+        return _server.routeActive((HttpRouteScope)route.scope) &&
+               (route.method == HTTP_ANY || route.method == method);
+    }
+
+    uint16_t find(HTTPMethod method, const char* uri) {
+        uint32_t hash = fnv1a(uri);
+        for (uint16_t i = _buckets[hash & (ROUTE_HASH_BUCKETS - 1)]; i != NO_ROUTE; i = _routes[i].next) {
+            const Route& route = _routes[i];
+            if (route.hash == hash && accepts(route, method) && strcmp(&_paths[route.path], uri) == 0) {
+                pathArgs.clear();
+                return i;
+            }
+        }
+
+        for (uint16_t i : _patterns) {
+            if (accepts(_routes[i], method) && matchPattern(&_paths[_routes[i].path], uri)) {
+                return i;
+            }
+        }
+
+        return NO_ROUTE;
+    }
+
+    // Matches "/sensor/{id}" against "/sensor/12", collecting "12"
+    bool matchPattern(const char* pattern, const char* uri) {
+        pathArgs.clear();
+
+        while (*pattern) {
+            if (*pattern == '{') {
+                const char* end = strchr(uri, '/');
+                size_t length = end ? (size_t)(end - uri) : strlen(uri);
+                if (length == 0) {
+                    return false;
+                }
+                pathArgs.emplace_back();
+                pathArgs.back().concat(uri, length);
+                uri += length;
+
+                pattern = strchr(pattern, '}');
+                if (!pattern) {
+                    return false;
+                }
+                pattern++;
+            } else if (*pattern++ != *uri++) {
+                return false;
+            }
+        }
+
+        return *uri == '\0';
+    }
+
+    const WebServerBackend& _server;
+    std::vector<char> _paths;
+    std::vector<Route> _routes;
+    std::vector<WebServer::THandlerFunction> _handlers;  // By route index
+    std::vector<uint16_t> _patterns;
+    uint16_t _buckets[ROUTE_HASH_BUCKETS];
+    uint16_t _matched;  // From the last canHandle(), used by handle()
+};
+
+void ESP32ProvisionToolkit::addRoute(const char* path, HTTPMethod method, HttpRouteScope scope,
+                                     WebServer::THandlerFunction handler, bool fallback) {
+    _routes->add(path, method, scope, handler, fallback);
+}
+
+void ESP32ProvisionToolkit::ensureWebServer() {
+    if (_webServer) {
+        return;
+    }
+
+    _webServer = createWebServer();
+    _webServer->collectHeaders(COLLECTED_HEADERS, sizeof(COLLECTED_HEADERS) / sizeof(COLLECTED_HEADERS[0]));
+
+    _routes = new RouteDispatcher(*_webServer);
+    _webServer->addHandler(_routes);
+
+    // Portal
+    addRoute("/", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleRoot);
+    addRoute(PORTAL_CSS_PATH, HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleStylesheet);
+    addRoute(PORTAL_JS_PATH, HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleScript);
+    addRoute("/theme.css", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleTheme);
+    addRoute("/scan", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleScan);
+    addRoute("/save", HTTP_POST, ROUTE_PROVISIONING_ONLY, staticHandleSave);
+
+    // This avoid captive portals redirect after form submission
+    addRoute("/save", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleSaveGet);
+    addRoute("/status", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleStatus);
+
+    addRoute("/networks", HTTP_GET, ROUTE_PROVISIONING_ONLY, staticHandleNetworks);
+    addRoute("/networks/remove", HTTP_POST, ROUTE_PROVISIONING_ONLY, staticHandleRemoveNetwork);
+
+    for (size_t i = 0; i < _customRoutes.size(); i++) {
+        registerCustomRoute(i);
+    }
+
+    // Fallbacks, so a sketch can still claim one of these paths, also with
+    // routes added after the server exists. /reset is always registered:
+    // the handler checks httpResetEnabled, which may change later.
+    addRoute("/reset", HTTP_POST, ROUTE_BOTH, staticHandleReset, true);
+    for (size_t i = 0; i < sizeof(CAPTIVE_PROBES) / sizeof(CAPTIVE_PROBES[0]); i++) {
+        addRoute(CAPTIVE_PROBES[i].path, HTTP_GET, ROUTE_PROVISIONING_ONLY,
+                 [this, i]() { handleCaptiveProbe(i); }, true);
+    }
+
+    _webServer->onNotFound(staticHandleNotFound);
+}
+
+void ESP32ProvisionToolkit::startWebServer(HttpRouteScope scope) {
+    ensureWebServer();
+    _webServer->setScope(scope);
+    _webServerActive = true;
+
+    const char* mode = scope == ROUTE_CONNECTED_ONLY ? "connected" : "provisioning";
+    if (_webServerListening) {
+        log(LOG_DEBUG, "Web server switched to %s routes", mode);
+        return;
+    }
+
+    _webServer->begin();
+    _webServerListening = true;
+    log(LOG_INFO, "Web server started on port %d (%s routes)", WEB_SERVER_PORT, mode);
+}
+
+WebServerBackend* ESP32ProvisionToolkit::createWebServer() {
+    if (_config.httpBackend == HTTP_BACKEND_MULTI_CLIENT) {
+        return new MultiClientWebServer(WEB_SERVER_PORT);
+    }
+    return new WebServerBackend(WEB_SERVER_PORT);
+}
+
+void ESP32ProvisionToolkit::stopWebServer() {
+    // The listener stays bound until the end of this loop() iteration, so a
+    // mode taking over right away (portal -> connected) doesn't rebind it
+    _webServerActive = false;
+}
+
+void ESP32ProvisionToolkit::releaseWebServer() {
+    if (_webServerListening && !_webServerActive) {
+        _webServer->stop();
+        _webServerListening = false;
+        log(LOG_DEBUG, "Web server stopped");
+    }
+}
+
+// ===== UX =====
+
+void ESP32ProvisionToolkit::updateLED() {
+    // LED is controlled by pattern set in setLEDPattern
+    // This is a simple implementation; could be enhanced with more patterns
+
+    static uint32_t onTime = 0;
+    static uint32_t offTime = 0;
+
+    if (_state == STATE_PROVISIONING || _state == STATE_PROVISIONING_ACTIVE) {
+        onTime = 100;
+        offTime = 100;
+    } else if (_state == STATE_CONNECTING || _state == STATE_RETRY_WAIT) {
+        onTime = 100;
+        offTime = 900;
+    } else if (_state == STATE_CONNECTED) {
+        onTime = 0;
+        offTime = 0;
+        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
+        return;
+    } else {
+        digitalWrite(_config.ledPin, _config.ledActiveLow ? HIGH : LOW);
+        return;
+    }
+
+    unsigned long now = millis();
+    uint32_t period = onTime + offTime;
+
+    if (period == 0) {
+        // Solid on
+        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
+        return;
+    }
+
+    unsigned long phase = now % period;
+    bool shouldBeOn = phase < onTime;
+
+    if (shouldBeOn) {
+        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
+    } else {
+        digitalWrite(_config.ledPin, _config.ledActiveLow ? HIGH : LOW);
+    }
+}
+
+void ESP32ProvisionToolkit::setLEDPattern(uint32_t onTime, uint32_t offTime) {
+    // This is handled directly in updateLED for simplicity
+    // A more sophisticated implementation would store patterns
+}
+
+// ===== Custom routes =====
+
+void ESP32ProvisionToolkit::registerCustomRoute(size_t i) {
+    const HttpRoute& route = _customRoutes[i];
+
+    addRoute(
+        route.path.c_str(),
+        route.method,
+        route.scope,
+        [this, i]() {
+            // By index: setRouteVersion() may change the entry later
+            const HttpRoute& route = _customRoutes[i];
+
+            // Optional authentication
+            if (route.requiresAuth) {
+                if (!_config.httpResetAuthRequired) {
+                    _webServer->send(403, "text/plain", "Authentication required");
+                    return;
+                }
+
+                String pwd = _webServer->arg("password");
+                if (!verifyPassword(pwd, _resetPassword)) {
+                    _webServer->send(401, "text/plain", "Invalid password");
+                    return;
+                }
+            }
+
+            // Versioned routes answer conditional GETs without running
+            // the handler
+            if (route.version.length() > 0 && _webServer->method() == HTTP_GET) {
+                String etag = "\"" + route.version + "\"";
+                _webServer->sendHeader("ETag", etag);
+                _webServer->sendHeader("Cache-Control", "no-cache");
+
+                if (isNotModified(etag.c_str())) {
+                    _webServer->send(304);
+                    return;
+                }
+            }
+
+            // Call user handler
+            route.handler(*_webServer);
+        }
+    );
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addHttpRoute(
+    const String& path,
+    HTTPMethod method,
+    HttpRouteHandler handler,
+    HttpRouteScope scope,
+    bool requiresAuth,
+    const String& version
+) {
+    ServiceLock lock(_lock);
+    _customRoutes.push_back({
+        path,
+        method,
+        handler,
+        scope,
+        requiresAuth,
+        version
+    });
+
+    // Routes added while the server exists are served right away
+    if (_webServer) {
+        registerCustomRoute(_customRoutes.size() - 1);
+    }
+
+    log(LOG_DEBUG, "Custom route registered: %s", path.c_str());
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::setRouteVersion(const String& path, const String& version) {
+    ServiceLock lock(_lock);
+    for (auto& route : _customRoutes) {
+        if (route.path == path) {
+            route.version = version;
+        }
+    }
+    return *this;
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addGet(
+    const String& path,
+    HttpRouteHandler handler,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addHttpRoute(path, HTTP_GET, handler, scope, requiresAuth);
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addPost(
+    const String& path,
+    HttpRouteHandler handler,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addHttpRoute(path, HTTP_POST, handler, scope, requiresAuth);
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addJsonRoute(
+    const String& path,
+    HTTPMethod method,
+    std::function<String()> jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addHttpRoute(
+        path,
+        method,
+        [jsonProvider](WebServer& s) {
+            s.send(200, "application/json", jsonProvider());
+        },
+        scope,
+        requiresAuth
+    );
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addGetJsonRoute(
+    const String& path,
+    std::function<String()> jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addJsonRoute(path, HTTP_GET, jsonProvider, scope, requiresAuth);
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addPostJsonRoute(
+    const String& path,
+    std::function<String()> jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addJsonRoute(path, HTTP_POST, jsonProvider, scope, requiresAuth);
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addJsonRoute(
+    const String& path,
+    HTTPMethod method,
+    JsonStreamProvider jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addHttpRoute(
+        path,
+        method,
+        [jsonProvider](WebServer& s) {
+            JsonStreamWriter json(s);
+            json.begin();
+            jsonProvider(json);
+            json.end();
+        },
+        scope,
+        requiresAuth
+    );
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addGetJsonRoute(
+    const String& path,
+    JsonStreamProvider jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addJsonRoute(path, HTTP_GET, jsonProvider, scope, requiresAuth);
+}
+
+ESP32ProvisionToolkit& ESP32ProvisionToolkit::addPostJsonRoute(
+    const String& path,
+    JsonStreamProvider jsonProvider,
+    HttpRouteScope scope,
+    bool requiresAuth
+) {
+    return addJsonRoute(path, HTTP_POST, jsonProvider, scope, requiresAuth);
+}
+
+// ===== JSON Streaming =====
+
+JsonStreamWriter::JsonStreamWriter(WebServer& server) :
+    _server(server),
+    _length(0),
+    _started(false),
+    _ended(false),
+    _needComma(false)
+{}
+
+JsonStreamWriter::~JsonStreamWriter() {
+    if (_started) {
+        end();
+    }
+}
+
+void JsonStreamWriter::begin(int code, const char* contentType) {
+    if (_started) {
+        return;
+    }
+
+    _started = true;
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(code, contentType, "");
+}
+
+JsonStreamWriter& JsonStreamWriter::beginObject() {
+    separator();
+    raw('{');
+    _needComma = false;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::endObject() {
+    raw('}');
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::beginArray() {
+    separator();
+    raw('[');
+    _needComma = false;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::endArray() {
+    raw(']');
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::key(const char* name) {
+    value(name);
+    raw(':');
+    _needComma = false;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(const char* str) {
+    if (!str) {
+        return nullValue();
+    }
+
+    separator();
+    raw('"');
+
+    for (const char* p = str; *p; p++) {
+        uint8_t c = *p;
+        switch (c) {
+            case '"':  raw("\\\"", 2); break;
+            case '\\': raw("\\\\", 2); break;
+            case '\n': raw("\\n", 2); break;
+            case '\r': raw("\\r", 2); break;
+            case '\t': raw("\\t", 2); break;
+            case '\b': raw("\\b", 2); break;
+            case '\f': raw("\\f", 2); break;
+            default:
+                if (c < 0x20) {
+                    char escaped[7];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    raw(escaped, 6);
+                } else {
+                    raw((char)c); // UTF-8 passes through unchanged
+                }
+                break;
+        }
+    }
+
+    raw('"');
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(const String& str) {
+    return value(str.c_str());
+}
+
+JsonStreamWriter& JsonStreamWriter::value(int number) {
+    return value((long)number);
+}
+
+JsonStreamWriter& JsonStreamWriter::value(unsigned int number) {
+    return value((unsigned long)number);
+}
+
+JsonStreamWriter& JsonStreamWriter::value(long number) {
+    char text[24];
+    separator();
+    raw(text, snprintf(text, sizeof(text), "%ld", number));
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(unsigned long number) {
+    char text[24];
+    separator();
+    raw(text, snprintf(text, sizeof(text), "%lu", number));
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(long long number) {
+    char text[24];
+    separator();
+    raw(text, snprintf(text, sizeof(text), "%lld", number));
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(unsigned long long number) {
+    char text[24];
+    separator();
+    raw(text, snprintf(text, sizeof(text), "%llu", number));
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(double number) {
+    // JSON has no NaN or infinity
+    if (isnan(number) || isinf(number)) {
+        return nullValue();
+    }
+
+    char text[24];
+    separator();
+    raw(text, snprintf(text, sizeof(text), "%.9g", number));
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::value(bool flag) {
+    separator();
+    if (flag) {
+        raw("true", 4);
+    } else {
+        raw("false", 5);
+    }
+    _needComma = true;
+    return *this;
+}
+
+JsonStreamWriter& JsonStreamWriter::nullValue() {
+    separator();
+    raw("null", 4);
+    _needComma = true;
+    return *this;
+}
+
+void JsonStreamWriter::end() {
+    if (_ended) {
+        return;
+    }
+
+    begin();
+    flush();
+    _server.sendContent(""); // Terminating chunk
+    _ended = true;
+}
+
+void JsonStreamWriter::separator() {
+    if (_needComma) {
+        raw(',');
+    }
+}
+
+void JsonStreamWriter::raw(const char* data, size_t length) {
+    while (length > 0) {
+        if (_length == sizeof(_buffer)) {
+            flush();
+        }
+
+        size_t n = sizeof(_buffer) - _length;
+        if (n > length) {
+            n = length;
+        }
+
+        memcpy(_buffer + _length, data, n);
+        _length += n;
+        data += n;
+        length -= n;
+    }
+}
+
+void JsonStreamWriter::raw(char c) {
+    if (_length == sizeof(_buffer)) {
+        flush();
+    }
+    _buffer[_length++] = c;
+}
+
+void JsonStreamWriter::flush() {
+    if (_ended || _length == 0) {
+        return;
+    }
+
+    begin();
+    _server.sendContent(_buffer, _length);
+    _length = 0;
+}
+
+// ===== Captive DNS =====
+
+#define DNS_HEADER_SIZE 12
+#define DNS_TYPE_A 1
+#define DNS_TYPE_AAAA 28
+#define DNS_TYPE_SVCB 64
+#define DNS_TYPE_HTTPS 65
+
+CaptiveDNSServer::CaptiveDNSServer() :
+    _socket(-1)
+{
+    memset(_answer, 0, sizeof(_answer));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+CaptiveDNSServer::~CaptiveDNSServer() {
+    stop();
+}
+
+bool CaptiveDNSServer::start(uint16_t port, const IPAddress& ip) {
+    stop();
+
+    _socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_socket < 0) {
+        return false;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        stop();
+        return false;
+    }
+
+    // Name (pointer to the question), type A, class IN, TTL, address
+    const uint8_t answer[sizeof(_answer)] = {
+        0xC0, DNS_HEADER_SIZE, 0x00, DNS_TYPE_A, 0x00, 0x01,
+        (uint8_t)(DNS_ANSWER_TTL_S >> 24), (uint8_t)(DNS_ANSWER_TTL_S >> 16),
+        (uint8_t)(DNS_ANSWER_TTL_S >> 8), (uint8_t)DNS_ANSWER_TTL_S,
+        0x00, 0x04, ip[0], ip[1], ip[2], ip[3]
+    };
+    memcpy(_answer, answer, sizeof(_answer));
+    memset(&_stats, 0, sizeof(_stats));
+    return true;
+}
 
-    // Reset endpoint
-    if (_config.httpResetEnabled) {
-        _webServer->on("/reset", HTTP_POST, staticHandleReset);
+void CaptiveDNSServer::stop() {
+    if (_socket >= 0) {
+        close(_socket);
+        _socket = -1;
     }
+}
 
-    if (hasCustomRoutes) {
-        registerCustomRoutes(ROUTE_CONNECTED_ONLY);
+size_t CaptiveDNSServer::processRequests() {
+    if (_socket < 0) {
+        return 0;
     }
 
-    _webServer->begin();
+    size_t count = 0;
+    while (count < DNS_MAX_BATCH) {
+        struct sockaddr_in client;
+        socklen_t clientLength = sizeof(client);
+        int received = recvfrom(_socket, _packet, DNS_PACKET_SIZE, MSG_DONTWAIT,
+                                (struct sockaddr*)&client, &clientLength);
+        if (received < 0) {
+            break;  // Queue drained
+        }
+        count++;
 
-    log(LOG_INFO, "Connected-mode web server started on port %d", WEB_SERVER_PORT);
-}
+        size_t length = answer(received);
+        if (length == 0) {
+            _stats.dropped++;
+            continue;
+        }
 
-void ESP32ProvisionToolkit::stopWebServer() {
-    if (_webServer) {
-        _webServer->stop();
-        delete _webServer;
-        _webServer = nullptr;
-        log(LOG_DEBUG, "Web server stopped");
+        sendto(_socket, _packet, length, 0, (struct sockaddr*)&client, clientLength);
     }
-}
 
-// ===== UX =====
+    return count;
+}
 
-void ESP32ProvisionToolkit::updateLED() {
-    // LED is controlled by pattern set in setLEDPattern
-    // This is a simple implementation; could be enhanced with more patterns
+size_t CaptiveDNSServer::answer(size_t length) {
+    uint8_t* p = _packet;
 
-    static uint32_t onTime = 0;
-    static uint32_t offTime = 0;
+    // Standard query (QR = 0, OPCODE = 0) with a single question
+    if (length < DNS_HEADER_SIZE || (p[2] & 0xF8) != 0 || p[4] != 0 || p[5] != 1) {
+        return 0;
+    }
 
-    if (_state == STATE_PROVISIONING || _state == STATE_PROVISIONING_ACTIVE) {
-        onTime = 100;
-        offTime = 100;
-    } else if (_state == STATE_CONNECTING || _state == STATE_RETRY_WAIT) {
-        onTime = 100;
-        offTime = 900;
-    } else if (_state == STATE_CONNECTED) {
-        onTime = 0;
-        offTime = 0;
-        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
-        return;
-    } else {
-        digitalWrite(_config.ledPin, _config.ledActiveLow ? HIGH : LOW);
-        return;
+    // Question name: plain labels up to the root, no compression in queries
+    size_t pos = DNS_HEADER_SIZE;
+    while (pos < length && p[pos] != 0) {
+        if (p[pos] & 0xC0) {
+            return 0;
+        }
+        pos += p[pos] + 1;
+    }
+    if (pos + 5 > length) {
+        return 0;
     }
 
-    unsigned long now = millis();
-    uint32_t period = onTime + offTime;
+    uint16_t type = (p[pos + 1] << 8) | p[pos + 2];
+    pos += 5;  // Root label, type, class
 
-    if (period == 0) {
-        // Solid on
-        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
-        return;
+    bool resolve = false;
+    switch (type) {
+        case DNS_TYPE_A:
+            _stats.a++;
+            resolve = true;
+            break;
+        case DNS_TYPE_AAAA:
+            _stats.aaaa++;
+            break;
+        case DNS_TYPE_SVCB:
+        case DNS_TYPE_HTTPS:
+            _stats.https++;
+            break;
+        default:
+            _stats.other++;
+            break;
     }
 
-    unsigned long phase = now % period;
-    bool shouldBeOn = phase < onTime;
-
-    if (shouldBeOn) {
-        digitalWrite(_config.ledPin, _config.ledActiveLow ? LOW : HIGH);
-    } else {
-        digitalWrite(_config.ledPin, _config.ledActiveLow ? HIGH : LOW);
+    // Reply in place: keep ID and question, drop any additional records
+    // (EDNS), answer A with the portal address and everything else empty
+    p[2] = 0x84 | (p[2] & 0x01);  // QR, AA, RD copied from the query
+    p[3] = 0x80;                  // RA, no error
+    p[6] = 0;
+    p[7] = resolve ? 1 : 0;
+    p[8] = p[9] = p[10] = p[11] = 0;
+
+    if (resolve) {
+        memcpy(p + pos, _answer, sizeof(_answer));
+        pos += sizeof(_answer);
     }
+
+    return pos;
 }
 
-void ESP32ProvisionToolkit::setLEDPattern(uint32_t onTime, uint32_t offTime) {
-    // This is handled directly in updateLED for simplicity
-    // A more sophisticated implementation would store patterns
+// ===== HTTP Backends =====
+
+size_t WebServerBackend::pollFds(int* fds, size_t max) const {
+    int fd = _currentClient.fd();
+    if (fd < 0 || max == 0) {
+        return 0;
+    }
+    fds[0] = fd;
+    return 1;
 }
 
-// ===== Custom routes =====
+MultiClientWebServer::MultiClientWebServer(int port) :
+    WebServerBackend(port)
+{
+    memset(_acceptTime, 0, sizeof(_acceptTime));
+    memset(_received, 0, sizeof(_received));
+}
 
-void ESP32ProvisionToolkit::registerCustomRoutes(HttpRouteScope activeScope) {
-    if (!_webServer) return;
+void MultiClientWebServer::poll() {
+    // Take every pending connection there is room for; the rest wait in
+    // the listen backlog
+    for (uint8_t slot = 0; slot < HTTP_MAX_CLIENTS; slot++) {
+        if (_clients[slot].fd() >= 0) {
+            continue;
+        }
+        WiFiClient client = _server.accept();
+        if (!client) {
+            break;
+        }
+        _clients[slot] = client;
+        _acceptTime[slot] = millis();
+        _received[slot] = 0;
+    }
 
-    for (const auto& route : _customRoutes) {
-        if (route.scope != activeScope && route.scope != ROUTE_BOTH) {
+    for (uint8_t slot = 0; slot < HTTP_MAX_CLIENTS; slot++) {
+        WiFiClient& client = _clients[slot];
+        if (client.fd() < 0) {
             continue;
         }
 
-        _webServer->on(
-            route.path.c_str(),
-            route.method,
-            [this, route]() {
+        if (requestReady(slot)) {
+            serve(slot);
+        } else if (!client.connected() || millis() - _acceptTime[slot] > HTTP_CLIENT_TIMEOUT_MS) {
+            client.stop();
+        }
+    }
+}
 
-                // Optional authentication
-                if (route.requiresAuth) {
-                    if (!_config.httpResetAuthRequired) {
-                        _webServer->send(403, "text/plain", "Authentication required");
-                        return;
-                    }
+// Value of the Content-Length header in a request head, 0 if absent
+static size_t requestContentLength(const char* head) {
+    for (const char* line = strstr(head, "\r\n"); line; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, "Content-Length:", 15) == 0) {
+            return strtoul(line + 15, nullptr, 10);
+        }
+    }
+    return 0;
+}
 
-                    String pwd = _webServer->arg("password");
-                    if (!verifyPassword(pwd, _resetPassword)) {
-                        _webServer->send(401, "text/plain", "Invalid password");
-                        return;
-                    }
-                }
+bool MultiClientWebServer::requestReady(uint8_t slot) {
+    WiFiClient& client = _clients[slot];
 
-                // Call user handler
-                route.handler(*_webServer);
-            }
-        );
+    // Only look again once more data has come in
+    int available = client.available();
+    if (available <= 0 || (size_t)available == _received[slot]) {
+        return false;
     }
-}
+    _received[slot] = available;
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addHttpRoute(
-    const String& path,
-    HTTPMethod method,
-    HttpRouteHandler handler,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    _customRoutes.push_back({
-        path,
-        method,
-        handler,
-        scope,
-        requiresAuth
-    });
+    // Nothing has been read from the connection yet: peek at the socket
+    int length = recv(client.fd(), _head, sizeof(_head) - 1, MSG_PEEK | MSG_DONTWAIT);
+    if (length <= 0) {
+        return false;
+    }
+    _head[length] = '\0';
 
-    log(LOG_DEBUG, "Custom route registered: %s", path.c_str());
-    return *this;
-}
+    const char* end = strstr(_head, "\r\n\r\n");
+    if (!end) {
+        // A head larger than the buffer is left to the parser to read
+        return length == (int)sizeof(_head) - 1;
+    }
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addGet(
-    const String& path,
-    HttpRouteHandler handler,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    return addHttpRoute(path, HTTP_GET, handler, scope, requiresAuth);
+    // Wait for the body too, unless it may not fit the receive window
+    size_t headLength = end + 4 - _head;
+    _head[headLength - 2] = '\0';  // Search the headers only
+    size_t body = requestContentLength(_head);
+    return body > HTTP_BUFFERED_BODY_MAX || (size_t)available >= headLength + body;
+}
+
+void MultiClientWebServer::serve(uint8_t slot) {
+    // Same steps as WebServer::handleClient() for a client with data, minus
+    // the wait for the client to close; responses carry "Connection: close".
+    // Built on its protected members, checked against arduino-esp32 2.0.17
+    // and 3.x (see the compile job in .github/workflows/linting.yml).
+    _currentClient = _clients[slot];
+    if (_parseRequest(_currentClient)) {
+        _currentClient.setTimeout(HTTP_MAX_SEND_WAIT);
+        _contentLength = CONTENT_LENGTH_NOT_SET;
+        _handleRequest();
+    }
+
+    // handleClient()'s per-request cleanup
+    _currentClient.stop();
+    _currentClient = WiFiClient();
+    _currentStatus = HC_NONE;
+    _currentUpload.reset();
+    _currentRaw.reset();
+    _clients[slot] = WiFiClient();
+    _received[slot] = 0;
+}
+
+void MultiClientWebServer::close() {
+    // Connections accepted before a stop() must not be served after the
+    // next begin()
+    for (uint8_t slot = 0; slot < HTTP_MAX_CLIENTS; slot++) {
+        _clients[slot].stop();
+        _clients[slot] = WiFiClient();
+        _received[slot] = 0;
+    }
+    WebServerBackend::close();
 }
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addPost(
-    const String& path,
-    HttpRouteHandler handler,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    return addHttpRoute(path, HTTP_POST, handler, scope, requiresAuth);
+size_t MultiClientWebServer::pollFds(int* fds, size_t max) const {
+    size_t count = 0;
+    for (uint8_t slot = 0; slot < HTTP_MAX_CLIENTS && count < max; slot++) {
+        int fd = _clients[slot].fd();
+        if (fd >= 0) {
+            fds[count++] = fd;
+        }
+    }
+    return count;
 }
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addJsonRoute(
-    const String& path,
-    HTTPMethod method,
-    std::function<String()> jsonProvider,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    return addHttpRoute(
-        path,
-        method,
-        [jsonProvider](WebServer& s) {
-            s.send(200, "application/json", jsonProvider());
-        },
-        scope,
-        requiresAuth
-    );
+// ===== Retry Policies =====
+
+uint32_t RetryPolicy::randomBetween(uint32_t low, uint32_t high) {
+    if (high <= low) {
+        return low;
+    }
+    return low + esp_random() % (high - low + 1);
 }
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addGetJsonRoute(
-    const String& path,
-    std::function<String()> jsonProvider,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    return addJsonRoute(path, HTTP_GET, jsonProvider, scope, requiresAuth);
+uint32_t ExponentialBackoffRetryPolicy::computeDelay(uint8_t attempt) {
+    // Double per attempt without overflowing, then cap
+    uint32_t delayMs = _base;
+    for (uint8_t i = 1; i < attempt && delayMs < _max; i++) {
+        delayMs = delayMs > _max / 2 ? _max : delayMs * 2;
+    }
+    if (delayMs > _max) {
+        delayMs = _max;
+    }
+
+    return _jitter ? randomBetween(delayMs / 2, delayMs) : delayMs;
 }
 
-ESP32ProvisionToolkit& ESP32ProvisionToolkit::addPostJsonRoute(
-    const String& path,
-    std::function<String()> jsonProvider,
-    HttpRouteScope scope,
-    bool requiresAuth
-) {
-    return addJsonRoute(path, HTTP_POST, jsonProvider, scope, requiresAuth);
+uint32_t DecorrelatedJitterRetryPolicy::computeDelay(uint8_t attempt) {
+    uint32_t upper = _previous > _max / 3 ? _max : _previous * 3;
+    uint32_t delayMs = randomBetween(_base, upper);
+    if (delayMs > _max) {
+        delayMs = _max;
+    }
+
+    _previous = delayMs;
+    return delayMs;
 }
 
 // ===== Utilities =====
@@ -1041,378 +3609,41 @@ String ESP32ProvisionToolkit::hashPassword(const String& password) {
     return hash;
 }
 
-bool ESP32ProvisionToolkit::verifyPassword(const String& password, const String& hash) {
-    return hashPassword(password) == hash;
-}
-
-String ESP32ProvisionToolkit::generateHTML() {
-    String html = R"(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>WiFi Configuration</title>
-    <style>
-        * { margin: 0; padding: 0; box-sizing: border-box; }
-
-        body {
-            font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', Roboto, 'Helvetica Neue', Arial, sans-serif;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            min-height: 100vh;
-            display: flex;
-            align-items: center;
-            justify-content: center;
-            padding: 20px;
-        }
-
-        .container {
-            background: white;
-            border-radius: 12px;
-            box-shadow: 0 20px 60px rgba(0,0,0,0.3);
-            max-width: 500px;
-            width: 100%;
-            overflow: hidden;
-        }
-
-        .header {
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-            padding: 30px;
-            text-align: center;
-        }
-
-        .header h1 {
-            font-size: 24px;
-            font-weight: 600;
-            margin-bottom: 8px;
-        }
-
-        .header p {
-            font-size: 14px;
-            opacity: 0.9;
-        }
-
-        .content {
-            padding: 30px;
-        }
-
-        .form-group {
-            margin-bottom: 20px;
-        }
-
-        label {
-            display: block;
-            margin-bottom: 8px;
-            font-weight: 500;
-            color: #333;
-            font-size: 14px;
-        }
-
-        input, select {
-            width: 100%;
-            padding: 12px;
-            border: 2px solid #e0e0e0;
-            border-radius: 8px;
-            font-size: 14px;
-            transition: border-color 0.3s;
-        }
-
-        input:focus, select:focus {
-            outline: none;
-            border-color: #667eea;
-        }
-
-        button {
-            width: 100%;
-            padding: 14px;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-            border: none;
-            border-radius: 8px;
-            font-size: 16px;
-            font-weight: 600;
-            cursor: pointer;
-            transition: transform 0.2s, box-shadow 0.2s;
-        }
-
-        button:hover {
-            transform: translateY(-2px);
-            box-shadow: 0 8px 20px rgba(102, 126, 234, 0.4);
-        }
-
-        button:active {
-            transform: translateY(0);
-        }
-
-        button:disabled {
-            opacity: 0.6;
-            cursor: not-allowed;
-            transform: none;
-        }
-
-        .scan-btn {
-            background: #f5f5f5;
-            color: #333;
-            margin-bottom: 15px;
-        }
-
-        .scan-btn:hover {
-            background: #e0e0e0;
-            box-shadow: 0 4px 12px rgba(0,0,0,0.1);
-        }
-
-        .network-list {
-            max-height: 200px;
-            overflow-y: auto;
-            border: 2px solid #e0e0e0;
-            border-radius: 8px;
-            margin-bottom: 20px;
-        }
-
-        .network-item {
-            padding: 12px;
-            border-bottom: 1px solid #f0f0f0;
-            cursor: pointer;
-            transition: background 0.2s;
-            display: flex;
-            justify-content: space-between;
-            align-items: center;
-        }
-
-        .network-item:last-child {
-            border-bottom: none;
-        }
-
-        .network-item:hover {
-            background: #f8f8f8;
-        }
-
-        .network-item.selected {
-            background: #e8edff;
-            color: #667eea;
-        }
-
-        .signal {
-            font-size: 12px;
-            opacity: 0.7;
-        }
-
-        .lock-icon::before {
-            content: "🔒";
-            margin-left: 8px;
-        }
-
-        .status {
-            padding: 12px;
-            border-radius: 8px;
-            margin-bottom: 20px;
-            font-size: 14px;
-            text-align: center;
-        }
-
-        .status.info {
-            background: #e3f2fd;
-            color: #1976d2;
-        }
-
-        .status.success {
-            background: #e8f5e9;
-            color: #388e3c;
-        }
-
-        .status.error {
-            background: #ffebee;
-            color: #d32f2f;
-        }
-
-        .hidden {
-            display: none;
-        }
-
-        .advanced {
-            margin-top: 20px;
-            padding-top: 20px;
-            border-top: 2px solid #f0f0f0;
-        }
-
-        .toggle-advanced {
-            background: none;
-            color: #667eea;
-            border: 2px solid #667eea;
-            margin-bottom: 20px;
-        }
-
-        .toggle-advanced:hover {
-            background: #667eea;
-            color: white;
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div class="header">
-            <h1>WiFi Configuration</h1>
-            <p>Configure your device's network connection</p>
-        </div>
-
-        <div class="content">
-            <div id="status" class="status hidden"></div>
-
-            <button class="scan-btn" onclick="scanNetworks();">Scan for Networks</button>
-
-            <div id="networks" class="network-list hidden"></div>
-
-            <form id="configForm" onsubmit="return saveConfig(event);">
-                <div class="form-group">
-                    <label for="ssid">Network Name (SSID)</label>
-                    <input type="text" id="ssid" name="ssid" required placeholder="Enter or select network">
-                </div>
-
-                <div class="form-group">
-                    <label for="password">Password</label>
-                    <input type="password" id="password" name="password" placeholder="Leave blank for open networks">
-                </div>
-
-)";
-
-    // Add reset password field if authentication is enabled
-    if (_config.httpResetAuthRequired) {
-        html += R"(
-                <button type="button" class="toggle-advanced" onclick="toggleAdvanced();">Advanced Options</button>
-
-                <div id="advanced" class="advanced hidden">
-                    <div class="form-group">
-                        <label for="reset_password">Reset Password (Optional)</label>
-                        <input type="password" id="reset_password" name="reset_password" placeholder="For remote device reset">
-                    </div>
-                </div>
-)";
-    }
-
-    html += R"(
-                <button type="submit" id="submitBtn">Save Configuration</button>
-            </form>
-        </div>
-    </div>
-
-    <script>
-        let networks = [];
-
-        function showStatus(message, type) {
-            const status = document.getElementById('status');
-            status.textContent = message;
-            status.className = 'status ' + type;
-            status.classList.remove('hidden');
-        }
-
-        function hideStatus() {
-            document.getElementById('status').classList.add('hidden');
-        }
-
-        function toggleAdvanced() {
-            const advanced = document.getElementById('advanced');
-            advanced.classList.toggle('hidden');
-        }
-
-        function scanNetworks() {
-            showStatus('Scanning for networks...', 'info');
-
-            fetch('/scan')
-                .then(response => response.json())
-                .then(data => {
-                    networks = data;
-                    displayNetworks(data);
-                    hideStatus();
-                })
-                .catch(error => {
-                    showStatus('Scan failed. Please try again.', 'error');
-                });
-        }
-
-        function displayNetworks(networks) {
-            const container = document.getElementById('networks');
-
-            if (networks.length === 0) {
-                container.innerHTML = '<div class="network-item">No networks found</div>';
-            } else {
-                container.innerHTML = networks.map((network, index) => {
-                    const signal = network.rssi;
-                    const bars = signal > -50 ? '▂▄▆█' : signal > -60 ? '▂▄▆' : signal > -70 ? '▂▄' : '▂';
-                    const lock = network.secure ? '<span class="lock-icon"></span>' : '';
-
-                    return `
-                        <div class="network-item" onclick="selectNetwork(${index});">
-                            <span>${network.ssid}</span>
-                            <span class="signal">${bars} ${lock}</span>
-                        </div>
-                    `;
-                }).join('');
-            }
-
-            container.classList.remove('hidden');
-        }
-
-        function selectNetwork(index) {
-            const network = networks[index];
-            document.getElementById('ssid').value = network.ssid;
-
-            // Highlight selected
-            document.querySelectorAll('.network-item').forEach((item, i) => {
-                if (i === index) {
-                    item.classList.add('selected');
-                } else {
-                    item.classList.remove('selected');
-                }
-            });
-
-            // Focus password field
-            document.getElementById('password').focus();
-        }
+String ESP32ProvisionToolkit::derivePMK(const String& ssid, const String& passphrase) {
+    // Only WPA2 passphrases (8-63 chars) map to a PMK; a 64-char value is already one
+    if (passphrase.length() < 8 || passphrase.length() > 63 || ssid.length() == 0) {
+        return "";
+    }
 
-        function saveConfig(event) {
-            // Prevent the form to trigger default behaviour (pt. 1)
-            event.preventDefault();
+    // PMK = PBKDF2-HMAC-SHA1(passphrase, ssid, 4096, 32)
+    byte pmk[32];
 
-            const formData = new FormData(event.target);
-            const submitBtn = document.getElementById('submitBtn');
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+    int ret = mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA1), 1);
+    if (ret == 0) {
+        ret = mbedtls_pkcs5_pbkdf2_hmac(&ctx,
+            (const unsigned char*)passphrase.c_str(), passphrase.length(),
+            (const unsigned char*)ssid.c_str(), ssid.length(),
+            4096, sizeof(pmk), pmk);
+    }
+    mbedtls_md_free(&ctx);
 
-            submitBtn.disabled = true;
-            submitBtn.textContent = 'Saving...';
-            showStatus('Saving configuration...', 'info');
+    if (ret != 0) {
+        log(LOG_ERROR, "PMK derivation failed (%d)", ret);
+        return "";
+    }
 
-            fetch('/save', {
-                method: 'POST',
-                body: new URLSearchParams(formData)
-            })
-            .then(response => {
-                if (response.ok) {
-                    showStatus('Configuration saved! Device is rebooting...', 'success');
-                    setTimeout(() => {
-                        showStatus('You can close this page and reconnect to your network.', 'info');
-                    }, 3000);
-                } else {
-                    throw new Error('Save failed');
-                }
-            })
-            .catch(error => {
-                showStatus('Failed to save configuration. Please try again.', 'error');
-                submitBtn.disabled = false;
-                submitBtn.textContent = 'Save Configuration';
-            });
-
-            // Prevent the form to trigger default behaviour (pt. 2)
-            return false;
-        }
+    String hex = "";
+    for (int i = 0; i < 32; i++) {
+        char byteHex[3];
+        sprintf(byteHex, "%02x", pmk[i]);
+        hex += byteHex;
+    }
 
-        // Auto-scan on load
-        window.addEventListener('load', function() {
-            setTimeout(scanNetworks, 500);
-        });
-    </script>
-</body>
-</html>
-)";
+    return hex;
+}
 
-    return html;
-}
\ No newline at end of file
+bool ESP32ProvisionToolkit::verifyPassword(const String& password, const String& hash) {
+    return hashPassword(password) == hash;
+}
@@ -25,6 +25,11 @@
 #include <ESPmDNS.h>
 #include <esp_system.h>
 #include <mbedtls/md.h>
+#include <mbedtls/pkcs5.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <deque>
 #include <functional>
 #include <vector>
 
@@ -36,10 +41,35 @@
 #define DEFAULT_AP_PASSWORD ""  // Open network
 #define DEFAULT_MAX_RETRIES 10
 #define DEFAULT_RETRY_DELAY_MS 3000
+#define DEFAULT_CONNECT_TIMEOUT_MS 10000
+#define DEFAULT_RETRY_MAX_DELAY_MS 60000
+#define DEFAULT_TRANSIENT_RETRY_DELAY_MS 500
+#define HANDSHAKE_TIMEOUT_AUTH_LIMIT 2  // Consecutive handshake timeouts treated as a wrong password
+#define DEFAULT_LEASE_CACHE_MAX_AGE_S 3600  // 1 hour
+#define DEFAULT_LEASE_REVALIDATE_DELAY_MS 0  // Revalidating restarts DHCP and drops open sockets
 #define DEFAULT_AP_TIMEOUT_MS 300000  // 5 minutes
+#define DEFAULT_BACKGROUND_RECONNECT_INTERVAL_MS 30000
+#define DEFAULT_SCAN_CACHE_TTL_MS 30000
 #define DEFAULT_RESET_BUTTON_DURATION_MS 5000
 #define DEFAULT_DOUBLE_REBOOT_WINDOW_MS 10000
+#define MAX_STORED_NETWORKS 8
+#define MAX_SCAN_RESULTS 20  // Distinct SSIDs listed by /scan
+#define JSON_WRITER_BUFFER_SIZE 256  // Bytes per chunk sent by JsonStreamWriter
+#define CREDENTIAL_TEST_SWITCHOVER_MS 5000  // Portal stays up this long after a successful test
 #define DNS_PORT 53
+#define DNS_PACKET_SIZE 512  // Largest query CaptiveDNSServer accepts (plain UDP DNS)
+#define DNS_ANSWER_TTL_S 60
+#define DNS_MAX_BATCH 32     // Queries CaptiveDNSServer answers per poll
+#define DEFAULT_PORTAL_POLL_BUDGET_MS 0  // Single pass per loop()
+#define PORTAL_POLL_SLICE_MS 10          // Longest wait before checking for new HTTP connections
+#define HTTP_MAX_CLIENTS 4             // Connections MultiClientWebServer serves at once
+#define HTTP_CLIENT_TIMEOUT_MS 5000    // Connections without a complete request are dropped after this
+#define HTTP_REQUEST_HEAD_SIZE 1024    // Request head MultiClientWebServer peeks at before dispatching
+#define HTTP_BUFFERED_BODY_MAX 2048    // Larger bodies are streamed by the parser, not waited for
+#define ROUTE_HASH_BUCKETS 32          // Exact-path buckets of the route table (power of two)
+#define DEFAULT_SERVICE_TASK_CORE 0
+#define DEFAULT_SERVICE_TASK_STACK_SIZE 8192
+#define DEFAULT_SERVICE_TASK_PRIORITY 1
 #define WEB_SERVER_PORT 80
 
 // Logging levels
@@ -61,6 +91,15 @@ enum ProvisionerState {
     STATE_PROVISIONING_ACTIVE
 };
 
+// Why the last connection attempt failed
+enum ConnectFailure {
+    FAILURE_NONE,
+    FAILURE_AUTH,       // Wrong password / rejected by the AP
+    FAILURE_NO_AP,      // SSID not found
+    FAILURE_TRANSIENT,  // Beacon/handshake timeouts, association errors...
+    FAILURE_TIMEOUT     // No result within the connect timeout
+};
+
 // Reset result codes
 enum ResetResult {
     RESET_SUCCESS = 0,
@@ -76,6 +115,12 @@ enum HttpRouteScope {
     ROUTE_BOTH
 };
 
+// HTTP server implementation used for the portal and custom routes
+enum HttpBackend {
+    HTTP_BACKEND_WEBSERVER,     // Stock WebServer, one client at a time
+    HTTP_BACKEND_MULTI_CLIENT   // MultiClientWebServer, concurrent connections
+};
+
 // Route descriptor
 typedef std::function<void(WebServer&)> HttpRouteHandler;
 
@@ -85,6 +130,269 @@ struct HttpRoute {
     HttpRouteHandler handler;
     HttpRouteScope scope;
     bool requiresAuth;
+    String version;  // ETag token for conditional GET, empty = not cacheable
+};
+
+// ===== JSON Streaming =====
+
+// Writes a JSON response straight to the client using chunked transfer
+// encoding. Output goes through a fixed buffer held by the writer, so heap
+// use does not grow with the size of the document. Commas and colons are
+// inserted automatically; strings are escaped.
+class JsonStreamWriter {
+public:
+    explicit JsonStreamWriter(WebServer& server);
+    ~JsonStreamWriter();
+
+    // Sends the status line and headers (implicit on first write)
+    void begin(int code = 200, const char* contentType = "application/json");
+
+    JsonStreamWriter& beginObject();
+    JsonStreamWriter& endObject();
+    JsonStreamWriter& beginArray();
+    JsonStreamWriter& endArray();
+    JsonStreamWriter& key(const char* name);
+
+    JsonStreamWriter& value(const char* str);
+    JsonStreamWriter& value(const String& str);
+    JsonStreamWriter& value(int number);
+    JsonStreamWriter& value(unsigned int number);
+    JsonStreamWriter& value(long number);
+    JsonStreamWriter& value(unsigned long number);
+    JsonStreamWriter& value(long long number);
+    JsonStreamWriter& value(unsigned long long number);
+    JsonStreamWriter& value(double number);
+    JsonStreamWriter& value(bool flag);
+    JsonStreamWriter& nullValue();
+
+    // key(name).value(v) in one call
+    template <typename T>
+    JsonStreamWriter& field(const char* name, T v) { return key(name).value(v); }
+
+    // Flushes the buffer and terminates the chunked response
+    void end();
+
+private:
+    void separator();
+    void raw(const char* data, size_t length);
+    void raw(char c);
+    void flush();
+
+    WebServer& _server;
+    char _buffer[JSON_WRITER_BUFFER_SIZE];
+    size_t _length;
+    bool _started;
+    bool _ended;
+    bool _needComma;
+};
+
+// Writes a JSON body through the writer instead of returning it as a String
+typedef std::function<void(JsonStreamWriter&)> JsonStreamProvider;
+
+// ===== Captive DNS =====
+
+// Queries answered by CaptiveDNSServer, by record type
+struct DNSStats {
+    uint32_t a;       // Answered with the portal address
+    uint32_t aaaa;    // Answered empty
+    uint32_t https;   // HTTPS/SVCB, answered empty
+    uint32_t other;   // Any other type, answered empty
+    uint32_t dropped; // Malformed or not a standard query
+};
+
+// Minimal DNS responder that resolves every name to the portal address.
+// Unlike DNSServer, each poll answers all pending queries, and replies are
+// built in a fixed packet buffer from a preformatted answer record, without
+// heap allocation. AAAA and HTTPS queries get an immediate empty answer so
+// clients fall back to IPv4 without waiting for a timeout.
+class CaptiveDNSServer {
+public:
+    CaptiveDNSServer();
+    ~CaptiveDNSServer();
+
+    bool start(uint16_t port, const IPAddress& ip);
+    void stop();
+
+    // Answers up to DNS_MAX_BATCH queued queries; returns how many were read
+    size_t processRequests();
+
+    const DNSStats& getStats() const { return _stats; }
+    int fd() const { return _socket; }
+
+private:
+    size_t answer(size_t length);
+
+    int _socket;
+    uint8_t _answer[16];  // Answer record pointing at the question name
+    uint8_t _packet[DNS_PACKET_SIZE + sizeof(_answer)];
+    DNSStats _stats;
+};
+
+// ===== HTTP Backends =====
+
+// Server used for the portal and connected-mode routes. Backends derive from
+// WebServer, so route handlers and JsonStreamWriter work with any of them;
+// they only differ in how connections are accepted and served.
+//
+// This base is the stock WebServer: one client at a time, and a client that
+// keeps its connection open holds up the next one.
+class WebServerBackend : public WebServer {
+public:
+    explicit WebServerBackend(int port) : WebServer(port), _scope(ROUTE_PROVISIONING_ONLY) {}
+    virtual ~WebServerBackend() {}
+
+    // Routes are registered once for both modes; only those of the current
+    // scope (and ROUTE_BOTH) match
+    void setScope(HttpRouteScope scope) { _scope = scope; }
+    HttpRouteScope scope() const { return _scope; }
+    bool routeActive(HttpRouteScope routeScope) const {
+        return routeScope == ROUTE_BOTH || routeScope == _scope;
+    }
+
+    // Serves whatever is ready, without blocking on idle connections
+    virtual void poll() { handleClient(); }
+
+    // Sockets worth waiting on in select() (client connections; the
+    // listening socket is private to WiFiServer). Returns how many were written.
+    virtual size_t pollFds(int* fds, size_t max) const;
+
+    // Closes the listener and every open connection. WebServer's own
+    // stop()/close() aren't virtual, so call these through the backend type.
+    virtual void close() { WebServer::close(); }
+    void stop() { close(); }
+
+private:
+    HttpRouteScope _scope;
+};
+
+// Event-driven backend: accepts up to HTTP_MAX_CLIENTS connections at once
+// and serves each one once its whole request (head and body) has arrived,
+// so slow, partial or idle clients don't delay the others.
+class MultiClientWebServer : public WebServerBackend {
+public:
+    explicit MultiClientWebServer(int port);
+
+    void poll() override;
+    size_t pollFds(int* fds, size_t max) const override;
+    void close() override;
+
+private:
+    bool requestReady(uint8_t slot);
+    void serve(uint8_t slot);
+
+    WiFiClient _clients[HTTP_MAX_CLIENTS];
+    unsigned long _acceptTime[HTTP_MAX_CLIENTS];
+    size_t _received[HTTP_MAX_CLIENTS];  // Bytes queued at the last check
+    char _head[HTTP_REQUEST_HEAD_SIZE];  // Peeked request head, shared by all slots
+};
+
+// ===== Retry Policies =====
+
+// Computes the delay before each reconnection attempt. Built-in policies are
+// below; custom ones only need to implement computeDelay() and name().
+class RetryPolicy {
+public:
+    virtual ~RetryPolicy() {}
+
+    // Delay in ms before the given attempt (1-based)
+    uint32_t nextDelay(uint8_t attempt) {
+        _lastDelay = computeDelay(attempt);
+        _lastAttempt = attempt;
+        return _lastDelay;
+    }
+
+    // Called once a connection succeeds
+    virtual void reset() {}
+
+    virtual const char* name() const = 0;
+
+    // Diagnostics
+    uint32_t lastDelay() const { return _lastDelay; }
+    uint8_t lastAttempt() const { return _lastAttempt; }
+
+protected:
+    virtual uint32_t computeDelay(uint8_t attempt) = 0;
+
+    // Uniform random value in [low, high]
+    static uint32_t randomBetween(uint32_t low, uint32_t high);
+
+private:
+    uint32_t _lastDelay = 0;
+    uint8_t _lastAttempt = 0;
+};
+
+// Same delay before every attempt
+class FixedRetryPolicy : public RetryPolicy {
+public:
+    explicit FixedRetryPolicy(uint32_t delayMs = DEFAULT_RETRY_DELAY_MS) : _delay(delayMs) {}
+
+    void setDelay(uint32_t delayMs) { _delay = delayMs; }
+    uint32_t fixedDelay() const { return _delay; }
+    const char* name() const override { return "fixed"; }
+
+protected:
+    uint32_t computeDelay(uint8_t attempt) override { return _delay; }
+
+private:
+    uint32_t _delay;
+};
+
+// base * 2^(attempt-1), capped at maxDelay; with jitter the delay is drawn
+// from [d/2, d] so devices that failed together spread out
+class ExponentialBackoffRetryPolicy : public RetryPolicy {
+public:
+    ExponentialBackoffRetryPolicy(uint32_t baseMs = DEFAULT_RETRY_DELAY_MS,
+                                  uint32_t maxMs = DEFAULT_RETRY_MAX_DELAY_MS,
+                                  bool jitter = true) :
+        _base(baseMs), _max(maxMs), _jitter(jitter) {}
+
+    void configure(uint32_t baseMs, uint32_t maxMs, bool jitter) {
+        _base = baseMs;
+        _max = maxMs;
+        _jitter = jitter;
+    }
+
+    uint32_t baseDelay() const { return _base; }
+    uint32_t maxDelay() const { return _max; }
+    bool hasJitter() const { return _jitter; }
+    const char* name() const override { return "exponential"; }
+
+protected:
+    uint32_t computeDelay(uint8_t attempt) override;
+
+private:
+    uint32_t _base;
+    uint32_t _max;
+    bool _jitter;
+};
+
+// "Decorrelated jitter": each delay is random in [base, 3 * previous],
+// capped at maxDelay
+class DecorrelatedJitterRetryPolicy : public RetryPolicy {
+public:
+    DecorrelatedJitterRetryPolicy(uint32_t baseMs = DEFAULT_RETRY_DELAY_MS,
+                                  uint32_t maxMs = DEFAULT_RETRY_MAX_DELAY_MS) :
+        _base(baseMs), _max(maxMs), _previous(baseMs) {}
+
+    void configure(uint32_t baseMs, uint32_t maxMs) {
+        _base = baseMs;
+        _max = maxMs;
+        _previous = baseMs;
+    }
+
+    void reset() override { _previous = _base; }
+
+    uint32_t baseDelay() const { return _base; }
+    uint32_t maxDelay() const { return _max; }
+    const char* name() const override { return "decorrelated-jitter"; }
+
+protected:
+    uint32_t computeDelay(uint8_t attempt) override;
+
+private:
+    uint32_t _base;
+    uint32_t _max;
+    uint32_t _previous;
 };
 
 // Configuration structure
@@ -93,11 +401,35 @@ struct WiFiProvisionerConfig {
     String apName;
     String apPassword;
     uint32_t apTimeout;
+    bool backgroundReconnectEnabled;      // Retry saved networks while the portal is up (AP+STA)
+    uint32_t backgroundReconnectInterval; // ms between background attempts
+    uint32_t scanCacheTTL;                // ms before /scan results are refreshed
+    const char* portalStylesheet;         // Extra CSS served as /theme.css, nullptr = none
+    bool fastDNSEnabled;                  // CaptiveDNSServer instead of DNSServer
+    uint32_t portalPollBudget;            // ms per loop() spent serving DNS and HTTP, 0 = one pass
+    HttpBackend httpBackend;              // Server for the portal and custom routes
 
     // Connection settings
     uint8_t maxRetries;
     uint32_t retryDelay;
+    uint32_t connectTimeout;
     bool autoWipeOnMaxRetries;
+    bool failFastOnAuthError;
+    uint32_t transientRetryDelay;
+    bool fastReconnectEnabled;
+    bool storePmkEnabled;
+
+    // IP configuration
+    bool staticIPEnabled;
+    IPAddress staticIP;
+    IPAddress staticGateway;
+    IPAddress staticSubnet;
+    IPAddress staticDNS1;
+    IPAddress staticDNS2;
+
+    bool leaseCacheEnabled;
+    uint32_t leaseCacheMaxAge;      // seconds
+    uint32_t leaseRevalidateDelay;  // ms after connecting, 0 = never
 
     // Hardware reset
     bool hardwareResetEnabled;
@@ -120,6 +452,12 @@ struct WiFiProvisionerConfig {
     bool doubleRebootDetectEnabled;
     uint32_t doubleRebootWindow;
 
+    // Service task (runs loop() on its own instead of the sketch's loop())
+    bool serviceTaskEnabled;
+    int8_t serviceTaskCore;         // -1 = no affinity
+    uint32_t serviceTaskStackSize;  // bytes
+    uint8_t serviceTaskPriority;
+
     // Logging
     LogLevel logLevel;
 
@@ -128,9 +466,25 @@ struct WiFiProvisionerConfig {
         apName(DEFAULT_AP_NAME),
         apPassword(DEFAULT_AP_PASSWORD),
         apTimeout(DEFAULT_AP_TIMEOUT_MS),
+        backgroundReconnectEnabled(false),
+        backgroundReconnectInterval(DEFAULT_BACKGROUND_RECONNECT_INTERVAL_MS),
+        scanCacheTTL(DEFAULT_SCAN_CACHE_TTL_MS),
+        portalStylesheet(nullptr),
+        fastDNSEnabled(false),
+        portalPollBudget(DEFAULT_PORTAL_POLL_BUDGET_MS),
+        httpBackend(HTTP_BACKEND_WEBSERVER),
         maxRetries(DEFAULT_MAX_RETRIES),
         retryDelay(DEFAULT_RETRY_DELAY_MS),
+        connectTimeout(DEFAULT_CONNECT_TIMEOUT_MS),
         autoWipeOnMaxRetries(true),
+        failFastOnAuthError(true),
+        transientRetryDelay(DEFAULT_TRANSIENT_RETRY_DELAY_MS),
+        fastReconnectEnabled(true),
+        storePmkEnabled(false),
+        staticIPEnabled(false),
+        leaseCacheEnabled(false),
+        leaseCacheMaxAge(DEFAULT_LEASE_CACHE_MAX_AGE_S),
+        leaseRevalidateDelay(DEFAULT_LEASE_REVALIDATE_DELAY_MS),
         hardwareResetEnabled(false),
         resetButtonPin(-1),
         resetButtonDuration(DEFAULT_RESET_BUTTON_DURATION_MS),
@@ -144,16 +498,23 @@ struct WiFiProvisionerConfig {
         mdnsName("esp32"),
         doubleRebootDetectEnabled(false),
         doubleRebootWindow(DEFAULT_DOUBLE_REBOOT_WINDOW_MS),
+        serviceTaskEnabled(false),
+        serviceTaskCore(DEFAULT_SERVICE_TASK_CORE),
+        serviceTaskStackSize(DEFAULT_SERVICE_TASK_STACK_SIZE),
+        serviceTaskPriority(DEFAULT_SERVICE_TASK_PRIORITY),
         logLevel(LOG_INFO)
     {}
 };
 
 // Callback function types
 typedef void (*WiFiConnectedCallback)();
-typedef void (*WiFiFailedCallback)(uint8_t retryCount);
+typedef void (*WiFiFailedCallback)(uint8_t retryCount, uint8_t reason);
+typedef void (*WiFiFailedLegacyCallback)(uint8_t retryCount);
 typedef void (*APModeCallback)(const char* ssid, const char* ip);
 typedef void (*ResetCallback)();
 
+class RouteDispatcher;
+
 class ESP32ProvisionToolkit {
 public:
     ESP32ProvisionToolkit();
@@ -165,11 +526,38 @@ public:
     ESP32ProvisionToolkit& setAPName(const String& name);
     ESP32ProvisionToolkit& setAPPassword(const String& password);
     ESP32ProvisionToolkit& setAPTimeout(uint32_t milliseconds);
+    ESP32ProvisionToolkit& setBackgroundReconnect(bool enable, uint32_t intervalMs = DEFAULT_BACKGROUND_RECONNECT_INTERVAL_MS);
+    ESP32ProvisionToolkit& setScanCacheTTL(uint32_t milliseconds);
+    ESP32ProvisionToolkit& setPortalStylesheet(const char* css);
+    ESP32ProvisionToolkit& setFastDNS(bool enable);
+    ESP32ProvisionToolkit& setPortalPollBudget(uint32_t milliseconds);
+    ESP32ProvisionToolkit& setHttpBackend(HttpBackend backend);
 
     // Connection Settings
     ESP32ProvisionToolkit& setMaxRetries(uint8_t retries);
     ESP32ProvisionToolkit& setRetryDelay(uint32_t milliseconds);
+    ESP32ProvisionToolkit& setExponentialBackoff(uint32_t baseMs, uint32_t maxMs = DEFAULT_RETRY_MAX_DELAY_MS, bool jitter = true);
+    ESP32ProvisionToolkit& setDecorrelatedJitterBackoff(uint32_t baseMs, uint32_t maxMs = DEFAULT_RETRY_MAX_DELAY_MS);
+    ESP32ProvisionToolkit& setRetryPolicy(RetryPolicy* policy);
+    ESP32ProvisionToolkit& setConnectTimeout(uint32_t milliseconds);
     ESP32ProvisionToolkit& setAutoWipeOnMaxRetries(bool enable);
+    ESP32ProvisionToolkit& setFailFastOnAuthError(bool enable);
+    ESP32ProvisionToolkit& setTransientRetryDelay(uint32_t milliseconds);
+    ESP32ProvisionToolkit& setFastReconnect(bool enable);
+    ESP32ProvisionToolkit& setStorePMK(bool enable);
+
+    // IP Settings
+    ESP32ProvisionToolkit& setStaticIP(
+        const IPAddress& ip,
+        const IPAddress& gateway,
+        const IPAddress& subnet,
+        const IPAddress& dns1 = IPAddress(),
+        const IPAddress& dns2 = IPAddress()
+    );
+    ESP32ProvisionToolkit& enableLeaseCache(
+        uint32_t maxAgeSeconds = DEFAULT_LEASE_CACHE_MAX_AGE_S,
+        uint32_t revalidateDelayMs = DEFAULT_LEASE_REVALIDATE_DELAY_MS
+    );
 
     // Hardware Reset
     ESP32ProvisionToolkit& enableHardwareReset(int8_t pin, uint32_t durationMs = DEFAULT_RESET_BUTTON_DURATION_MS, bool activeLow = true);
@@ -190,8 +578,10 @@ public:
         HTTPMethod method,
         HttpRouteHandler handler,
         HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
-        bool requiresAuth = false
+        bool requiresAuth = false,
+        const String& version = String()
     );
+    ESP32ProvisionToolkit& setRouteVersion(const String& path, const String& version);
     ESP32ProvisionToolkit& addGet(
         const String& path,
         HttpRouteHandler handler,
@@ -211,18 +601,45 @@ public:
         HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
         bool requiresAuth = false
     );
+    ESP32ProvisionToolkit& addJsonRoute(
+        const String& path,
+        HTTPMethod method,
+        JsonStreamProvider jsonProvider,
+        HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
+        bool requiresAuth = false
+    );
     ESP32ProvisionToolkit& addGetJsonRoute(
         const String& path,
         std::function<String()> jsonProvider,
         HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
         bool requiresAuth = false
     );
+    ESP32ProvisionToolkit& addGetJsonRoute(
+        const String& path,
+        JsonStreamProvider jsonProvider,
+        HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
+        bool requiresAuth = false
+    );
     ESP32ProvisionToolkit& addPostJsonRoute(
         const String& path,
         std::function<String()> jsonProvider,
         HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
         bool requiresAuth = false
     );
+    ESP32ProvisionToolkit& addPostJsonRoute(
+        const String& path,
+        JsonStreamProvider jsonProvider,
+        HttpRouteScope scope = ROUTE_CONNECTED_ONLY,
+        bool requiresAuth = false
+    );
+
+    // Service task
+    ESP32ProvisionToolkit& setServiceTask(
+        bool enable,
+        int8_t core = DEFAULT_SERVICE_TASK_CORE,
+        uint32_t stackSize = DEFAULT_SERVICE_TASK_STACK_SIZE,
+        uint8_t priority = DEFAULT_SERVICE_TASK_PRIORITY
+    );
 
     // Logging
     ESP32ProvisionToolkit& setLogLevel(LogLevel level);
@@ -230,21 +647,27 @@ public:
     // Callbacks
     ESP32ProvisionToolkit& onConnected(WiFiConnectedCallback callback);
     ESP32ProvisionToolkit& onFailed(WiFiFailedCallback callback);
+    ESP32ProvisionToolkit& onFailed(WiFiFailedLegacyCallback callback);
     ESP32ProvisionToolkit& onAPMode(APModeCallback callback);
     ESP32ProvisionToolkit& onReset(ResetCallback callback);
 
     // ===== Core Control =====
     bool begin();
-    void loop();
+    void loop();   // No-op while the service task runs
     void reset();  // Programmatic reset
 
     // ===== Status Query =====
     bool isConnected() const;
     bool isProvisioning() const;
     ProvisionerState getState() const;
+    uint8_t getRetryCount() const;
+    const RetryPolicy& getRetryPolicy() const;
+    ConnectFailure getLastFailure() const;
+    uint8_t getLastDisconnectReason() const;
     String getSSID() const;
     IPAddress getLocalIP() const;
     String getAPIP() const;
+    DNSStats getDNSStats() const;
 
     // ===== Custom Route Introspection =====
     bool hasCustomRoutes() const;
@@ -255,34 +678,177 @@ public:
     bool setCredentials(const String& ssid, const String& password, bool reboot = true);
     bool clearCredentials(bool reboot = true);
 
+    // ===== Saved Networks =====
+    bool addNetwork(const String& ssid, const String& password);
+    bool removeNetwork(const String& ssid);
+    uint8_t getNetworkCount() const;
+    std::vector<String> getNetworks() const;
+
 private:
+    // One saved network; the whole list is persisted as a single NVS blob
+    struct StoredNetwork {
+        char ssid[33];
+        char secret[65];    // Passphrase, or hex-encoded PMK when isPmk
+        uint8_t isPmk;
+        uint8_t bssid[6];   // Last AP that handed out an IP
+        uint8_t channel;    // 0 = unknown
+        uint8_t history;    // Last 8 outcomes, newest in bit 0 (1 = success)
+        uint32_t lastUsed;  // Sequence number of the last successful connection
+    };
+
+    // Last DHCP lease, persisted as a single NVS blob
+    struct CachedLease {
+        uint32_t ssidHash;  // Network the lease belongs to
+        uint32_t ip;
+        uint32_t gateway;
+        uint32_t subnet;
+        uint32_t dns1;
+        uint32_t dns2;
+        uint32_t obtainedAt;  // time(), seconds
+    };
+
+    // One SSID from the last scan, merged over all of its access points
+    struct ScanResult {
+        char ssid[33];
+        int8_t rssi;        // Strongest access point
+        uint8_t channel;    // Channel of that access point
+        uint8_t authMode;   // wifi_auth_mode_t
+    };
+
+    // Outcome of a single, non-blocking connection attempt
+    enum ConnectAttemptStatus {
+        CONNECT_PENDING,
+        CONNECT_SUCCEEDED,
+        CONNECT_FAILED
+    };
+
+    // Runtime credential change, applied from loop() without a reboot
+    enum ReconfigureRequest {
+        RECONFIGURE_NONE,
+        RECONFIGURE_SWITCH,     // Try new credentials, fall back to the saved ones
+        RECONFIGURE_RECONNECT,  // Reconnect with the saved networks
+        RECONFIGURE_PROVISION   // Credentials cleared: open the portal
+    };
+
+    // Portal credential test (submitted credentials are tried before saving)
+    enum CredentialTestState {
+        TEST_IDLE,
+        TEST_RUNNING,
+        TEST_SUCCEEDED,
+        TEST_FAILED
+    };
+
     // Configuration
     WiFiProvisionerConfig _config;
 
-    // State management
-    ProvisionerState _state;
-    uint8_t _retryCount;
+    // State management (volatile: status queries read these without _lock)
+    volatile ProvisionerState _state;
+    volatile uint8_t _retryCount;
     unsigned long _lastRetryTime;
+    uint32_t _retryDelay;
+
+    // Retry policies (built-ins are owned, custom ones are not)
+    FixedRetryPolicy _fixedRetryPolicy;
+    ExponentialBackoffRetryPolicy _exponentialRetryPolicy;
+    DecorrelatedJitterRetryPolicy _jitterRetryPolicy;
+    RetryPolicy* _retryPolicy;
+
+    // Failure classification
+    volatile ConnectFailure _lastFailure;
+    volatile uint8_t _failureReason;
+    uint8_t _handshakeTimeouts;
+    bool _waitingForAP;
+
+    // Background scan, shared by network ranking and /scan
+    bool _scanInProgress;
+    bool _rankRequested;    // Rank saved networks when the scan completes
+    bool _rankReady;
+    ScanResult _scanResults[MAX_SCAN_RESULTS];  // Strongest first
+    uint8_t _scanResultCount;
+    bool _scanResultsValid;
+    unsigned long _scanCacheTime;
     unsigned long _apStartTime;
+    unsigned long _lastBackgroundAttempt;
     unsigned long _buttonPressStart;
     bool _buttonPressed;
 
     // Storage
     Preferences _preferences;
-    String _storedSSID;
-    String _storedPassword;
+    String _storedSSID;      // Network being tried / connected
+    String _storedPassword;  // Passphrase, or hex-encoded PMK when storePmkEnabled
+    char _ssidSnapshot[33];  // Copy of _storedSSID for getSSID(), guarded by _ssidMux
+    mutable portMUX_TYPE _ssidMux = portMUX_INITIALIZER_UNLOCKED;
     String _resetPassword;
 
+    // Saved networks and the ranked candidates of the current cycle
+    StoredNetwork _networks[MAX_STORED_NETWORKS];
+    uint8_t _networkCount;
+    uint32_t _networkSequence;
+    int8_t _activeNetwork;
+    uint8_t _candidates[MAX_STORED_NETWORKS];
+    uint8_t _candidateCount;
+    uint8_t _candidateIndex;
+    uint8_t _scanChannel[MAX_STORED_NETWORKS];  // From the ranking scan, 0 = not seen
+    uint8_t _scanBSSID[MAX_STORED_NETWORKS][6];
+
+    // Directed (scan-less) connects
+    bool _skipDirectedConnect;
+    bool _directedAttempt;
+
+    // Cached DHCP lease
+    CachedLease _cachedLease;
+    bool _usingCachedLease;
+    bool _skipCachedLease;
+    bool _leaseRevalidatePending;
+    unsigned long _connectedTime;
+
+    // Connection attempt (flags are written from the WiFi event task)
+    wifi_event_id_t _wifiEventId;
+    bool _connectInProgress;
+    unsigned long _connectStartTime;
+    volatile bool _staConnected;
+    volatile bool _staGotIP;
+    volatile bool _ipEventPending;
+    volatile bool _staDisconnected;
+    volatile uint8_t _lastDisconnectReason;
+
+    // Runtime credential change
+    ReconfigureRequest _reconfigure;
+    bool _switchPending;    // Next connect attempt uses _switchSSID
+    String _switchSSID;
+    String _switchPassword;
+
+    // Credential test from the portal
+    CredentialTestState _testState;
+    String _testSSID;
+    String _testPassword;
+    String _testResetPassword;
+    uint8_t _testReason;
+    const char* _testMessage;
+    unsigned long _testDoneTime;
+
+    uint32_t _themeHash;  // ETag of /theme.css
+
+    // Captive portal detection
+    char _portalURL[24];  // "http://<AP IP>/"
+    uint8_t _probedOS;    // OSes already reported, one bit each
+
     // Network components
     DNSServer* _dnsServer;
-    WebServer* _webServer;
+    CaptiveDNSServer* _fastDNS;
+    WebServerBackend* _webServer;  // Created once, kept across mode changes
+    RouteDispatcher* _routes;      // Route table, owned by _webServer
+    bool _webServerActive;         // Some mode needs the server
+    bool _webServerListening;
 
-    // Custom routes
-    std::vector<HttpRoute> _customRoutes;
+    // Custom routes; a deque, so a handler adding a route doesn't move the
+    // entry (and std::function) that is running
+    std::deque<HttpRoute> _customRoutes;
 
     // Callbacks
     WiFiConnectedCallback _onConnectedCallback;
     WiFiFailedCallback _onFailedCallback;
+    WiFiFailedLegacyCallback _onFailedLegacyCallback;
     APModeCallback _onAPModeCallback;
     ResetCallback _onResetCallback;
 
@@ -290,16 +856,32 @@ private:
     unsigned long _lastLedToggle;
     bool _ledState;
 
+    // Service task; mutating public calls take _lock while it runs
+    TaskHandle_t _serviceTask;
+    SemaphoreHandle_t _lock;
+    volatile bool _serviceStop;             // Set by the destructor, read between iterations
+    volatile TaskHandle_t _serviceStopWaiter;  // Notified once the task has let go
+
     // ===== Internal Methods =====
 
     // Storage
     bool loadCredentials();
-    bool saveCredentials(const String& ssid, const String& password);
+    bool saveCredentials(const String& ssid, const String& password, bool preferred = true);
+    bool persistNetworks();
+    int8_t findNetwork(const String& ssid) const;
+    void selectNetwork(uint8_t index);
+    void setCurrentNetwork(const String& ssid, const String& secret);
+    void recordConnectResult(bool success);
+    void loadLease();
+    void saveLease();
+    bool isCachedLeaseFresh();
     bool loadResetPassword();
     bool saveResetPassword(const String& password);
     void clearAllCredentials();
 
     // State machine
+    void service();
+    static void serviceTaskMain(void* arg);
     void handleStateInit();
     void handleStateLoadConfig();
     void handleStateConnecting();
@@ -309,31 +891,68 @@ private:
     void handleStateProvisioningActive();
 
     // Connection
-    bool connectToWiFi();
+    void beginConnectAttempt();
+    ConnectAttemptStatus pollConnectAttempt();
+    void abortConnectAttempt();
     void disconnectWiFi();
+    void applyIPConfig();
+    void handleWiFiEvent(arduino_event_id_t event, arduino_event_info_t info);
+    ConnectFailure classifyFailure(uint8_t reason);
+    void handleConnectSuccess();
+    void handleConnectFailure();
+    void handleRetriesExhausted();
+    void handleBackgroundReconnect();
+    void handleCredentialTest();
+    void applyReconfigure();
+    void finishCredentialTest(bool success);
+    static const char* describeFailure(uint8_t reason, bool associated);
+    bool rankNetworks(bool requireScan);
+    void rankScanResults(int16_t count);
+    void startScan();
+    void pollScan();
+    void cacheScanResults(int16_t count);
+    void notifyFailed();
 
     // Provisioning
     void startProvisioningMode();
     void stopProvisioningMode();
-    void setupWebServerProvisioningMode();
+    void servicePortal();
+    size_t portalPollFds(int* fds) const;
+    static void waitForSockets(const int* fds, size_t count, uint32_t timeoutMs);
     void handleRoot();
+    void handleStylesheet();
+    void handleScript();
+    void handleTheme();
+    void sendAsset(const char* contentType, const uint8_t* gz, size_t gzLength, size_t size,
+                   const char* hash, const char* cacheControl);
+    bool isNotModified(const char* etag);
     void handleScan();
     void handleSave();
     void handleSaveGet();
+    void handleStatus();
+    void handleNetworks();
+    void handleRemoveNetwork();
     void handleReset();
     void handleNotFound();
+    void handleCaptiveProbe(size_t index);
 
     // Reset mechanisms
     void checkHardwareReset();
     void checkDoubleReboot();
     void performReset(const char* reason);
 
-    // Connected-mode web server
+    // Web server
+    WebServerBackend* createWebServer();
+    void ensureWebServer();
+    void addRoute(const char* path, HTTPMethod method, HttpRouteScope scope, WebServer::THandlerFunction handler,
+                  bool fallback = false);
+    void startWebServer(HttpRouteScope scope);
     void startConnectedWebServer();
     void stopWebServer();
+    void releaseWebServer();
 
     // Custom routes helpers
-    void registerCustomRoutes(HttpRouteScope activeScope);
+    void registerCustomRoute(size_t index);
 
     // UX
     void updateLED();
@@ -343,15 +962,21 @@ private:
     void log(LogLevel level, const char* format, ...);
     String getMACAddress();
     String hashPassword(const String& password);
+    String derivePMK(const String& ssid, const String& passphrase);
     bool verifyPassword(const String& password, const String& hash);
-    String generateHTML();
 
     // Static web server handlers (need access to instance)
     static ESP32ProvisionToolkit* _instance;
     static void staticHandleRoot();
+    static void staticHandleStylesheet();
+    static void staticHandleScript();
+    static void staticHandleTheme();
     static void staticHandleScan();
     static void staticHandleSave();
     static void staticHandleSaveGet();
+    static void staticHandleStatus();
+    static void staticHandleNetworks();
+    static void staticHandleRemoveNetwork();
     static void staticHandleReset();
     static void staticHandleNotFound();
 };
@@ -0,0 +1,287 @@
+// Generated by extras/portal/build_portal.py from extras/portal/.
+// Do not edit: change the sources and run the script again.
+
+#ifndef ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H
+#define ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Largest back-reference distance in the compressed assets
+constexpr size_t PORTAL_GZ_WINDOW = 2048;
+
+// PORTAL_CSS: 3535 bytes source, 2671 minified, 1009 gzipped
+constexpr size_t PORTAL_CSS_SIZE = 2671;
+constexpr char PORTAL_CSS_HASH[] = "13f326c641caa56d";
+constexpr uint8_t PORTAL_CSS_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x55, 0xcb, 0x8e, 0xa4, 0x36,
+    0x14, 0xfd, 0x15, 0x34, 0xa5, 0x51, 0x77, 0x47, 0x80, 0x80, 0xea, 0xaa, 0xae, 0x36, 0xab, 0x64,
+    0x11, 0x25, 0x8b, 0x64, 0x91, 0x51, 0x16, 0x59, 0x1a, 0x7c, 0x01, 0xa7, 0x5d, 0x36, 0xc2, 0xa6,
+    0x1e, 0x41, 0xfc, 0x44, 0x94, 0xfd, 0xfc, 0x62, 0x3e, 0x21, 0xd7, 0xbc, 0x0a, 0xaa, 0xc9, 0x48,
+    0xa3, 0x44, 0x48, 0x25, 0xa0, 0xec, 0xeb, 0x73, 0xee, 0x39, 0xf7, 0xf0, 0x4d, 0x73, 0xa4, 0x55,
+    0xce, 0x25, 0x09, 0xe2, 0x92, 0x32, 0xc6, 0x65, 0x8e, 0x77, 0x89, 0xba, 0x78, 0x9a, 0xff, 0x61,
+    0x1f, 0x12, 0x55, 0x31, 0xa8, 0x3c, 0x7c, 0xd3, 0x26, 0x8a, 0x5d, 0x9b, 0x4c, 0x49, 0xe3, 0x65,
+    0xf4, 0xc8, 0xc5, 0x95, 0x78, 0xb4, 0x2c, 0x05, 0x78, 0xfa, 0xaa, 0x0d, 0x1c, 0xdd, 0xef, 0x04,
+    0x97, 0x6f, 0x3f, 0xd1, 0xf4, 0x53, 0xf7, 0xf8, 0x3d, 0xae, 0x73, 0x1f, 0x3e, 0x41, 0xae, 0xc0,
+    0xf9, 0xf5, 0xc7, 0x07, 0xf7, 0x17, 0x95, 0x28, 0xa3, 0xdc, 0x87, 0x1f, 0x40, 0x9c, 0xc0, 0xf0,
+    0x94, 0x3a, 0x3f, 0x43, 0x0d, 0x0f, 0xee, 0xb7, 0x15, 0xa7, 0xc2, 0xd5, 0x54, 0x6a, 0x4f, 0x43,
+    0xc5, 0xb3, 0x38, 0xa1, 0xe9, 0x5b, 0x5e, 0xa9, 0x5a, 0x32, 0x82, 0x05, 0x81, 0x56, 0x5e, 0x5e,
+    0x51, 0xc6, 0x41, 0x9a, 0xc7, 0x70, 0xbb, 0x63, 0x90, 0xbb, 0x9b, 0xfd, 0xfe, 0x05, 0x80, 0x3a,
+    0xc1, 0x47, 0x77, 0xf3, 0xb2, 0x7f, 0x4e, 0x68, 0xe4, 0x84, 0x41, 0xf0, 0xf1, 0x29, 0x3e, 0x72,
+    0xe9, 0x15, 0xc0, 0xf3, 0xc2, 0x10, 0x7c, 0x71, 0x2a, 0x62, 0xc6, 0x75, 0x29, 0xe8, 0x95, 0x64,
+    0x02, 0x2e, 0x31, 0x15, 0x3c, 0x97, 0x1e, 0x47, 0x6c, 0x9a, 0xa4, 0x58, 0x0e, 0xaa, 0xf8, 0xf7,
+    0x5a, 0x1b, 0x9e, 0x5d, 0xbd, 0x14, 0xc1, 0xe2, 0x9b, 0xf1, 0xf5, 0xd8, 0x88, 0x28, 0x28, 0x2f,
+    0xad, 0x6f, 0xff, 0xa4, 0x88, 0xa4, 0x6a, 0x66, 0xd0, 0xce, 0x05, 0x16, 0x8a, 0x87, 0xe6, 0x58,
+    0x7c, 0xb5, 0x26, 0x61, 0x54, 0x5e, 0xfa, 0xd6, 0x15, 0x94, 0xa9, 0x33, 0x09, 0x1c, 0x5b, 0xc0,
+    0xd9, 0xdb, 0x9f, 0x2a, 0x4f, 0xe8, 0x63, 0xe0, 0x76, 0x97, 0xbf, 0x45, 0xa8, 0xf4, 0xe2, 0x9d,
+    0x39, 0x33, 0x05, 0xd9, 0x05, 0xf8, 0x7f, 0xdc, 0xdf, 0x5b, 0x1a, 0xb1, 0x3a, 0x41, 0x95, 0x09,
+    0xdc, 0x5f, 0x70, 0xc6, 0x40, 0xb6, 0x7e, 0x01, 0x94, 0x2d, 0x4f, 0xff, 0xda, 0xc6, 0xa4, 0x4a,
+    0xa8, 0x6a, 0xc0, 0x3c, 0x92, 0xdb, 0xda, 0x63, 0x0d, 0x5c, 0x8c, 0xd7, 0x35, 0x66, 0xe0, 0x3e,
+    0x9e, 0xe6, 0x14, 0x61, 0x2f, 0x35, 0xda, 0x00, 0x48, 0xf4, 0x8c, 0x6b, 0xbb, 0xc7, 0x73, 0xdf,
+    0xde, 0x7d, 0x10, 0xc4, 0xbd, 0x6f, 0xd0, 0x19, 0xc6, 0xa8, 0x23, 0x39, 0xd8, 0x56, 0x0d, 0x7b,
+    0xcb, 0xd9, 0xd6, 0xd0, 0x6e, 0x55, 0x25, 0x4d, 0xb9, 0xb9, 0x92, 0xc0, 0x7f, 0xed, 0xfb, 0x89,
+    0x67, 0x35, 0x73, 0x20, 0xad, 0x9f, 0xa9, 0xea, 0xe8, 0x59, 0x7a, 0x65, 0xb3, 0x2c, 0xdc, 0x89,
+    0x20, 0x68, 0x02, 0xa2, 0x19, 0xe5, 0x4c, 0x84, 0x4a, 0xdf, 0xde, 0x9f, 0xbf, 0x40, 0x88, 0x6d,
+    0x1d, 0x68, 0x6f, 0xb6, 0xdb, 0x6d, 0xbc, 0x04, 0xd4, 0x72, 0x59, 0xd6, 0xc6, 0xd5, 0x20, 0x20,
+    0x35, 0xcd, 0xac, 0xf7, 0x23, 0xa6, 0x41, 0x4a, 0xab, 0x2e, 0xc1, 0x5b, 0x47, 0x2b, 0xc1, 0x99,
+    0xb3, 0x81, 0xc0, 0x5e, 0x77, 0xb2, 0x4f, 0x27, 0xdf, 0xf8, 0x9a, 0x0a, 0xfd, 0xcc, 0x0d, 0x57,
+    0x72, 0x9c, 0x9f, 0x0e, 0x8a, 0x83, 0xd2, 0xeb, 0xfe, 0x6c, 0x92, 0xa9, 0xb4, 0xd6, 0x03, 0x82,
+    0xfe, 0xa1, 0x51, 0xb5, 0xb1, 0xc2, 0x12, 0xa9, 0xe4, 0x64, 0xad, 0x81, 0x42, 0x2f, 0x6c, 0x9b,
+    0xd4, 0xc8, 0x55, 0xae, 0x02, 0xb6, 0xc7, 0xfe, 0x4f, 0x0e, 0x19, 0x78, 0xcf, 0x61, 0xac, 0x53,
+    0xdd, 0xaf, 0xb8, 0x22, 0xad, 0x2b, 0x8d, 0x95, 0x4a, 0xc5, 0xbb, 0x51, 0x9a, 0x75, 0xa2, 0xbb,
+    0xb5, 0x32, 0x63, 0x1b, 0x22, 0xed, 0xde, 0x06, 0xa5, 0x7b, 0x1e, 0xb8, 0x91, 0xc2, 0xda, 0xbf,
+    0x99, 0xd6, 0xf6, 0xbb, 0x04, 0x35, 0xf0, 0xdb, 0xa3, 0x87, 0x4a, 0x3c, 0x2d, 0x07, 0x0c, 0x01,
+    0xf5, 0x43, 0xd6, 0xcd, 0x57, 0x18, 0x44, 0x6e, 0x18, 0xed, 0xdd, 0x68, 0xfb, 0x8c, 0x53, 0xf6,
+    0xfc, 0x34, 0xd6, 0xa4, 0xa9, 0xe1, 0x27, 0x58, 0x2f, 0x1a, 0x4c, 0xab, 0xd0, 0x5d, 0x34, 0x11,
+    0xc0, 0x9a, 0x9b, 0x5b, 0xf7, 0x23, 0x1d, 0xa9, 0xec, 0x98, 0xe0, 0x50, 0x02, 0x8b, 0x6f, 0x65,
+    0x6c, 0x87, 0x5a, 0x5f, 0xa7, 0x14, 0x5d, 0x68, 0xe4, 0x7c, 0x40, 0x37, 0xd9, 0xce, 0x5e, 0x73,
+    0x07, 0x2e, 0xed, 0x1a, 0xee, 0xac, 0xe9, 0xc7, 0xad, 0x03, 0xeb, 0x79, 0x81, 0xc9, 0x6a, 0x33,
+    0xb6, 0xa8, 0xb1, 0x63, 0x9d, 0xb9, 0x4c, 0x93, 0xf0, 0xa9, 0xf5, 0x25, 0x98, 0xb3, 0xaa, 0xde,
+    0x3c, 0xc1, 0xb5, 0x69, 0x6c, 0xb6, 0x0c, 0x31, 0x18, 0x75, 0xe1, 0x32, 0x26, 0x8a, 0x77, 0x25,
+    0xb4, 0x36, 0xea, 0x6b, 0x8c, 0xbd, 0x32, 0x8b, 0xd3, 0x61, 0x36, 0x4a, 0x9b, 0x95, 0x89, 0x99,
+    0x38, 0xde, 0xea, 0x67, 0x81, 0xbd, 0xbe, 0x60, 0x8e, 0x1b, 0xf5, 0xce, 0x0d, 0xcb, 0xe4, 0xbe,
+    0x8f, 0x69, 0x8d, 0x02, 0x81, 0x97, 0x20, 0x0c, 0x00, 0xb9, 0x92, 0xeb, 0x4b, 0x88, 0x44, 0x50,
+    0x6d, 0xbc, 0xb4, 0xe0, 0x82, 0x35, 0x4b, 0x80, 0xbd, 0x7e, 0x8b, 0xb5, 0xef, 0x85, 0xc8, 0x0e,
+    0xf6, 0x5a, 0x2e, 0xf3, 0xfb, 0xb9, 0x45, 0xaf, 0x2c, 0x24, 0x3b, 0x00, 0xcb, 0xb2, 0x78, 0x39,
+    0xb2, 0xbe, 0x46, 0x74, 0x54, 0xcc, 0x13, 0x31, 0x5a, 0x24, 0xe2, 0x4b, 0xeb, 0xdb, 0x38, 0xf3,
+    0x38, 0xb2, 0x23, 0x24, 0x01, 0x74, 0x16, 0x34, 0x23, 0xd3, 0x0f, 0x7f, 0x7f, 0xfe, 0xeb, 0xcf,
+    0x0f, 0xa3, 0x0a, 0x02, 0x32, 0xd3, 0x07, 0xad, 0x36, 0xd4, 0x60, 0x62, 0xac, 0x35, 0xff, 0x8b,
+    0xe2, 0xbd, 0x0b, 0xaa, 0xf7, 0xf9, 0xdf, 0x97, 0xf6, 0xb9, 0xcc, 0xd4, 0x92, 0xdd, 0x36, 0x8b,
+    0x32, 0x36, 0xb2, 0x0b, 0x5f, 0x5f, 0xf6, 0x2c, 0x9a, 0x56, 0xeb, 0x3a, 0x4d, 0x41, 0xeb, 0xbb,
+    0x76, 0x64, 0x3b, 0x78, 0x9d, 0x46, 0xe0, 0x70, 0x80, 0x6d, 0x3a, 0x6d, 0x80, 0xaa, 0x52, 0x77,
+    0x7d, 0xce, 0x20, 0x01, 0x18, 0x97, 0xb3, 0x6d, 0x84, 0xc7, 0xe1, 0x17, 0x85, 0x33, 0x06, 0x72,
+    0x4a, 0xfe, 0x5e, 0x31, 0xca, 0x4e, 0x54, 0xa6, 0xd8, 0xfd, 0x81, 0xa0, 0x51, 0x65, 0xcf, 0x6e,
+    0xe8, 0xc7, 0xed, 0xc5, 0xd0, 0x93, 0xee, 0xf9, 0xde, 0x8d, 0xad, 0x6f, 0x54, 0x9e, 0x0b, 0xf0,
+    0xa6, 0x72, 0x33, 0x38, 0x5d, 0xf8, 0x2d, 0x94, 0x5c, 0x99, 0x9a, 0xe1, 0x8f, 0xb5, 0x19, 0xb9,
+    0x2b, 0xbd, 0xe2, 0xab, 0x61, 0xf3, 0x2c, 0x78, 0xb1, 0x39, 0xf4, 0xf4, 0xdf, 0x59, 0x75, 0x45,
+    0x9c, 0x22, 0x6a, 0xee, 0xb4, 0x9e, 0x27, 0xf5, 0xce, 0x26, 0xf5, 0xbf, 0x65, 0x53, 0xe7, 0xb0,
+    0x0a, 0x8e, 0x08, 0xb9, 0xcb, 0xb5, 0xfe, 0x73, 0xd3, 0x25, 0xc7, 0x68, 0xb8, 0x2e, 0x89, 0xee,
+    0xfc, 0x14, 0x2d, 0xbf, 0x40, 0xeb, 0x82, 0xfe, 0x03, 0xc2, 0xaf, 0x6a, 0xd5, 0x6f, 0x0a, 0x00,
+    0x00,
+};
+constexpr size_t PORTAL_CSS_GZ_LEN = sizeof(PORTAL_CSS_GZ);
+
+// PORTAL_JS: 6444 bytes source, 4712 minified, 1592 gzipped
+constexpr size_t PORTAL_JS_SIZE = 4712;
+constexpr char PORTAL_JS_HASH[] = "e6ebddd1eba0c38f";
+constexpr uint8_t PORTAL_JS_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x55, 0xcd, 0x6e, 0x1b, 0x37,
+    0x10, 0xbe, 0xeb, 0x29, 0x18, 0xf4, 0xc0, 0x15, 0x2c, 0x6f, 0x94, 0x00, 0x69, 0x01, 0xab, 0x49,
+    0x90, 0x1f, 0x07, 0x08, 0x60, 0x38, 0x46, 0xec, 0x9e, 0x82, 0xa0, 0xa0, 0x77, 0x47, 0x12, 0x1b,
+    0x8a, 0xdc, 0x92, 0x5c, 0x2b, 0x82, 0xe3, 0x4b, 0x51, 0x14, 0x7d, 0x02, 0x3f, 0xa0, 0x9f, 0xa4,
+    0x33, 0x5c, 0xee, 0xaf, 0x24, 0xc7, 0xcd, 0x45, 0xe2, 0x72, 0x86, 0x33, 0xdf, 0xcc, 0x7c, 0x33,
+    0xa3, 0xc0, 0x33, 0x0d, 0x7e, 0x6d, 0xec, 0x17, 0xc7, 0x9e, 0xb3, 0x4f, 0x9f, 0x67, 0xa3, 0x79,
+    0xa9, 0x33, 0x2f, 0x8d, 0x66, 0x6e, 0x69, 0xd6, 0xe7, 0x5e, 0xf8, 0xd2, 0x25, 0x2b, 0x70, 0x4e,
+    0x2c, 0x60, 0xc2, 0xfc, 0xa6, 0x80, 0x31, 0xbb, 0x1e, 0x65, 0x46, 0x3b, 0xcf, 0x5c, 0x90, 0xe2,
+    0xbb, 0xdc, 0x64, 0xe5, 0x0a, 0xb4, 0x4f, 0x17, 0xe0, 0x8f, 0x15, 0xd0, 0xf1, 0xf5, 0xe6, 0x7d,
+    0x9e, 0xf0, 0x4a, 0x83, 0x8f, 0x67, 0xa3, 0xea, 0x94, 0x7a, 0xf8, 0xea, 0xdf, 0x18, 0xed, 0x51,
+    0x03, 0xdf, 0x45, 0xbb, 0x8d, 0x34, 0x53, 0xc2, 0xb9, 0x53, 0xb1, 0x02, 0x94, 0xc5, 0xb7, 0x8c,
+    0xb3, 0x83, 0xe0, 0xb6, 0xaf, 0x74, 0x22, 0x9d, 0x4f, 0x2d, 0xac, 0xcc, 0x15, 0x24, 0x7c, 0x29,
+    0xf3, 0x1c, 0x34, 0x79, 0xb9, 0x69, 0xe1, 0xe3, 0x25, 0x44, 0xf8, 0x84, 0xf8, 0xbb, 0x10, 0x3b,
+    0x76, 0x45, 0x9e, 0xef, 0x31, 0xea, 0xcd, 0x62, 0xa1, 0xe0, 0x55, 0x7e, 0x25, 0x74, 0x06, 0x79,
+    0xd2, 0xa6, 0x42, 0xc4, 0xab, 0xfb, 0x92, 0x51, 0xeb, 0x90, 0xcd, 0xfa, 0xdc, 0xf1, 0x5a, 0xd9,
+    0xde, 0xe3, 0xd8, 0x65, 0x42, 0x9f, 0xc6, 0x42, 0x05, 0xb7, 0x9d, 0xea, 0xf0, 0x73, 0x14, 0x6a,
+    0xa9, 0x17, 0x6c, 0x6e, 0x6c, 0x53, 0xce, 0x34, 0x4d, 0xf9, 0x84, 0x71, 0xa9, 0xe7, 0x86, 0x6c,
+    0xcd, 0xc1, 0x67, 0xcb, 0x84, 0x3f, 0x26, 0x43, 0x7c, 0x3c, 0x4a, 0xfd, 0x12, 0x74, 0x62, 0xc1,
+    0x15, 0x08, 0x1f, 0xd3, 0xfd, 0x02, 0x4d, 0xca, 0x39, 0x6b, 0x6e, 0xd2, 0xba, 0xb6, 0xcf, 0x9f,
+    0xb3, 0xa7, 0xd3, 0xa7, 0xc1, 0x23, 0xf8, 0x0b, 0xb9, 0x02, 0x53, 0xfa, 0xa4, 0x8b, 0x66, 0xc2,
+    0x9e, 0x4c, 0xa7, 0x53, 0xf4, 0x60, 0xc1, 0x97, 0x56, 0x33, 0x5d, 0x2a, 0x45, 0xd0, 0xe3, 0x67,
+    0x63, 0xf0, 0x0f, 0x67, 0x74, 0x42, 0x41, 0xd5, 0xce, 0x73, 0xe1, 0x45, 0xeb, 0xf8, 0x11, 0x7d,
+    0x8e, 0x59, 0xf5, 0x6a, 0x36, 0xea, 0x90, 0x92, 0x04, 0xb3, 0x51, 0x2e, 0x5d, 0xa1, 0xc4, 0xa6,
+    0xc9, 0x41, 0x50, 0x9f, 0x8d, 0xba, 0x55, 0xae, 0x6c, 0x67, 0x82, 0x02, 0x05, 0x6b, 0x31, 0x17,
+    0xc1, 0xfa, 0x30, 0x53, 0x6c, 0x2e, 0xa4, 0xc2, 0xcc, 0xb3, 0x33, 0x05, 0x02, 0x63, 0xf7, 0x76,
+    0xc3, 0xc4, 0x42, 0x48, 0x1d, 0xf2, 0x15, 0x1e, 0x86, 0xe4, 0xf7, 0x0b, 0x10, 0x01, 0xbd, 0xf7,
+    0xb0, 0x4a, 0x88, 0xc4, 0x6d, 0xe9, 0x25, 0x5e, 0x75, 0xcb, 0x9e, 0x59, 0x10, 0x1e, 0x62, 0xe5,
+    0x13, 0x9e, 0xcb, 0x2b, 0x32, 0x47, 0x5a, 0x7d, 0x7e, 0x47, 0x8b, 0x87, 0x24, 0xe1, 0xb3, 0x68,
+    0x4c, 0x89, 0x4b, 0x50, 0xf7, 0x58, 0x73, 0x85, 0x08, 0xd4, 0x08, 0x7a, 0x83, 0x6e, 0xa2, 0xaf,
+    0xe8, 0x48, 0x14, 0x05, 0xe8, 0xfc, 0xcd, 0x52, 0xaa, 0x3c, 0x09, 0xaa, 0x6d, 0x7d, 0x48, 0xde,
+    0x8b, 0x6c, 0x98, 0xd9, 0x3a, 0xf5, 0x6d, 0x84, 0xf8, 0xeb, 0x31, 0x3f, 0x60, 0xef, 0x63, 0x77,
+    0xfd, 0x8c, 0xd0, 0x35, 0x0f, 0xb0, 0x45, 0xd1, 0x76, 0x06, 0x01, 0x89, 0x85, 0x40, 0x00, 0xaa,
+    0x76, 0x43, 0x52, 0x05, 0x7a, 0xe1, 0x97, 0x81, 0x66, 0xd3, 0xe8, 0x30, 0xbe, 0xec, 0x86, 0xd0,
+    0x4d, 0x3e, 0x3f, 0x35, 0xed, 0xc8, 0x9a, 0x9b, 0x52, 0x63, 0x3f, 0x51, 0xa9, 0x18, 0x28, 0x2c,
+    0xe6, 0x75, 0xc3, 0x9c, 0x14, 0x9b, 0xe1, 0x58, 0x20, 0x15, 0xea, 0xd7, 0x13, 0x26, 0x75, 0x0e,
+    0x5f, 0xc7, 0x15, 0x2b, 0xe2, 0x04, 0x93, 0x0b, 0x2d, 0x28, 0xdf, 0x51, 0x27, 0xb5, 0xce, 0xc9,
+    0x59, 0xbf, 0xb0, 0x5d, 0xe7, 0xb5, 0x1a, 0x6a, 0xe5, 0xe3, 0x5a, 0xef, 0x52, 0x58, 0xf7, 0x80,
+    0x92, 0x91, 0xda, 0x60, 0xc2, 0x05, 0xef, 0x3c, 0x8a, 0xfa, 0xc5, 0x4c, 0x22, 0xb4, 0x17, 0xec,
+    0xf0, 0xd9, 0x94, 0xbd, 0x64, 0xfc, 0xee, 0xf6, 0xaf, 0xbb, 0xdb, 0xbf, 0xef, 0x6e, 0xff, 0xb9,
+    0xbb, 0xfd, 0x97, 0xb3, 0x23, 0xd6, 0xca, 0x7f, 0xee, 0xcb, 0xfb, 0xc2, 0x5f, 0x3a, 0x42, 0x92,
+    0xd0, 0x91, 0x8f, 0x71, 0xa6, 0x72, 0xc6, 0x7b, 0xb5, 0x48, 0x1d, 0x64, 0xa5, 0xed, 0x4c, 0x77,
+    0x65, 0xb2, 0x2f, 0x0f, 0x61, 0x22, 0xaa, 0xf5, 0xc3, 0xa2, 0x9b, 0x43, 0x89, 0x46, 0xea, 0xc8,
+    0x7a, 0x6c, 0x44, 0x61, 0xe8, 0xac, 0x2d, 0x9e, 0x92, 0x6a, 0xdd, 0x28, 0x46, 0x67, 0x4a, 0x06,
+    0xf7, 0x49, 0xa8, 0x97, 0x03, 0x05, 0x99, 0x8f, 0x14, 0x4d, 0xaa, 0x3a, 0xce, 0xf6, 0x90, 0x85,
+    0x0c, 0x34, 0xfd, 0xdb, 0xaa, 0x3c, 0x70, 0x6d, 0xec, 0xf2, 0xd4, 0xa4, 0x24, 0xa6, 0xaa, 0x25,
+    0x85, 0xfb, 0x14, 0x34, 0x3e, 0xcf, 0xee, 0xd9, 0x2f, 0x48, 0x15, 0xdc, 0x2e, 0x57, 0x42, 0x95,
+    0xd0, 0x21, 0x1a, 0x5d, 0x77, 0x5e, 0xfd, 0x59, 0x82, 0xdd, 0x9c, 0x07, 0xdf, 0xc6, 0xbe, 0x52,
+    0x2a, 0xe1, 0x3f, 0x35, 0x24, 0x4f, 0x7b, 0x93, 0x62, 0xdc, 0x12, 0x9b, 0xbe, 0x91, 0xd5, 0xe3,
+    0x76, 0x8a, 0xca, 0xd0, 0x49, 0x0d, 0xea, 0x76, 0xe8, 0xb4, 0x7b, 0xad, 0x0a, 0xb0, 0xda, 0x42,
+    0x4d, 0xd3, 0x0c, 0x14, 0xeb, 0x0c, 0xf5, 0x74, 0x43, 0x46, 0xf7, 0x86, 0x59, 0xe0, 0x5b, 0x04,
+    0x99, 0x07, 0x7c, 0x59, 0x1c, 0xc7, 0x6d, 0x5a, 0x95, 0x11, 0xf9, 0xb9, 0xb8, 0x82, 0x3c, 0x2c,
+    0xaf, 0x7a, 0x19, 0xb5, 0x33, 0x63, 0xc7, 0x42, 0x1a, 0x6c, 0x8e, 0xed, 0xb5, 0x11, 0x5b, 0x98,
+    0xac, 0xde, 0x37, 0x98, 0x82, 0x02, 0x8f, 0x83, 0x87, 0x5e, 0x6f, 0x0d, 0x9d, 0xa0, 0x31, 0xcc,
+    0x53, 0xcb, 0x8e, 0x7a, 0x27, 0xdd, 0xd4, 0x8d, 0x81, 0x3a, 0xdf, 0x75, 0x48, 0x86, 0x42, 0x7b,
+    0x54, 0xf9, 0xdc, 0x9a, 0x82, 0x01, 0x48, 0x5d, 0xc9, 0x86, 0x57, 0x2f, 0x86, 0x5b, 0xe5, 0xfb,
+    0xc3, 0xa7, 0xf4, 0x1e, 0xf3, 0xbb, 0xbf, 0x4f, 0x2b, 0x85, 0x30, 0x80, 0xc2, 0x29, 0xf5, 0x9b,
+    0x22, 0xb4, 0x69, 0x14, 0x34, 0xf7, 0xbd, 0x1e, 0xae, 0x18, 0x70, 0x78, 0xe9, 0x3b, 0x0a, 0xfd,
+    0x01, 0xc5, 0x3f, 0x06, 0x95, 0x56, 0x3c, 0xec, 0xd9, 0xca, 0x44, 0x55, 0xf4, 0x01, 0xf4, 0xed,
+    0xde, 0x0f, 0x26, 0xea, 0x74, 0xed, 0xe9, 0xe6, 0x61, 0x99, 0x76, 0xf4, 0x31, 0x92, 0x24, 0x13,
+    0xc4, 0xad, 0x0a, 0xc2, 0xf5, 0x4d, 0x9f, 0x85, 0x5d, 0x48, 0x01, 0xca, 0x0e, 0x2e, 0x3e, 0xae,
+    0x94, 0xf8, 0x04, 0x65, 0x2b, 0xf0, 0x4b, 0x93, 0xe3, 0xd0, 0x3c, 0xfb, 0x70, 0x7e, 0xc1, 0x27,
+    0xa3, 0x4b, 0x93, 0x6f, 0x8e, 0xb0, 0x26, 0x6b, 0xf6, 0xdb, 0xc7, 0x93, 0x73, 0x10, 0x36, 0x5b,
+    0x9e, 0x09, 0x2b, 0x56, 0x2e, 0xb9, 0x66, 0x64, 0xef, 0x28, 0xfc, 0x32, 0x84, 0x71, 0x33, 0xae,
+    0xd8, 0xda, 0xf0, 0x7e, 0x30, 0x65, 0xf0, 0x0a, 0x53, 0x39, 0x97, 0x8b, 0x04, 0xae, 0x30, 0x9f,
+    0x04, 0x24, 0x1c, 0xd2, 0xc2, 0x86, 0xff, 0xb7, 0x30, 0x17, 0xa5, 0xf2, 0x49, 0x53, 0x67, 0xa4,
+    0xca, 0xea, 0x6d, 0xa0, 0x7e, 0xf0, 0xff, 0x2e, 0x7e, 0x56, 0xcf, 0x53, 0x2f, 0x2c, 0xb2, 0xb0,
+    0x51, 0x76, 0xe5, 0xe5, 0x4a, 0xfa, 0xd7, 0x5e, 0xdf, 0x4b, 0xd3, 0x5a, 0x89, 0x32, 0xd7, 0x7c,
+    0xa4, 0xb9, 0x74, 0xe2, 0x52, 0x85, 0x96, 0xf2, 0xb6, 0x84, 0xae, 0x68, 0x40, 0x00, 0x3c, 0x6a,
+    0x1c, 0x0f, 0x52, 0x2f, 0xd2, 0x34, 0x45, 0x1e, 0xb8, 0xa5, 0x59, 0x9f, 0x7b, 0xe1, 0xb1, 0xf9,
+    0x3b, 0x32, 0xe6, 0x0d, 0xee, 0x9a, 0x83, 0x26, 0x00, 0xc2, 0x51, 0x4f, 0x45, 0x5a, 0x43, 0xf4,
+    0x76, 0xc2, 0xb8, 0xd4, 0x73, 0x43, 0x40, 0xea, 0x72, 0x50, 0x86, 0xfe, 0x67, 0x0d, 0x6a, 0x0f,
+    0xe3, 0xc0, 0x83, 0xad, 0x79, 0x52, 0x4d, 0xc8, 0x66, 0xaa, 0x98, 0x2f, 0x94, 0xf4, 0x95, 0x74,
+    0x0e, 0xf2, 0x33, 0xa3, 0x94, 0xc3, 0x90, 0xa6, 0x18, 0x04, 0xf8, 0x0b, 0xb9, 0x02, 0x53, 0xfa,
+    0xa4, 0xc0, 0xdb, 0x2a, 0x9e, 0x09, 0x7b, 0x36, 0x9d, 0x76, 0xe7, 0x65, 0x35, 0x12, 0xda, 0x11,
+    0x45, 0x99, 0x49, 0x62, 0xc9, 0xe9, 0x1c, 0xfc, 0x31, 0xbf, 0xb4, 0x66, 0x1d, 0xa0, 0x1e, 0x5b,
+    0x6b, 0x6c, 0x90, 0x8c, 0x67, 0xec, 0x26, 0x4e, 0xd3, 0x9a, 0xab, 0x40, 0xc2, 0x0a, 0x21, 0x45,
+    0xfd, 0x4e, 0x48, 0x4c, 0x7f, 0x75, 0x9b, 0xae, 0xc0, 0x39, 0xb1, 0x00, 0xf6, 0xed, 0x1b, 0xe3,
+    0x95, 0x80, 0xf2, 0x49, 0x6a, 0x2c, 0x0b, 0xfc, 0x29, 0xad, 0x20, 0x46, 0xa5, 0xec, 0x4c, 0x81,
+    0x40, 0x6c, 0xde, 0x6e, 0x98, 0x58, 0xe0, 0xca, 0x4b, 0x79, 0x6c, 0x9b, 0x88, 0x75, 0x2e, 0x10,
+    0xfa, 0x16, 0x09, 0xa3, 0xb3, 0xe8, 0xa6, 0xdd, 0x74, 0x3f, 0xc0, 0xa0, 0xb6, 0xfa, 0xd1, 0x1a,
+    0x56, 0x35, 0x04, 0xb1, 0x97, 0x5f, 0x11, 0xd2, 0x5e, 0x82, 0x51, 0xe3, 0xb0, 0x37, 0xdd, 0x30,
+    0x39, 0x05, 0xa0, 0xc0, 0xb3, 0xad, 0xba, 0x35, 0x51, 0xb5, 0x55, 0xeb, 0xad, 0x1a, 0x17, 0xae,
+    0x7e, 0x6c, 0xd1, 0x6c, 0x39, 0x6b, 0x36, 0x09, 0x59, 0x85, 0xb0, 0x48, 0xb8, 0x07, 0x47, 0x74,
+    0xe7, 0x61, 0xa1, 0xb4, 0xb9, 0x88, 0x6a, 0x50, 0x54, 0x5a, 0xe6, 0xd2, 0x63, 0x6d, 0x50, 0xef,
+    0x77, 0x59, 0x70, 0xf6, 0x92, 0xf1, 0x0f, 0xf5, 0x05, 0x7b, 0x7f, 0xc6, 0x70, 0xf1, 0x20, 0x18,
+    0x47, 0x2d, 0xc1, 0x8e, 0x86, 0x0d, 0xd6, 0x69, 0x92, 0x87, 0x90, 0x74, 0x17, 0xc6, 0xac, 0x32,
+    0x08, 0xf9, 0x10, 0x65, 0xed, 0x0a, 0xf2, 0x47, 0xec, 0x2d, 0x5c, 0xc9, 0x0c, 0x10, 0xce, 0x51,
+    0xe8, 0xdb, 0x60, 0x43, 0x16, 0xa1, 0x55, 0xd9, 0xc5, 0x52, 0x3a, 0x86, 0xde, 0xcb, 0xa2, 0xde,
+    0x4c, 0x6c, 0x2d, 0x95, 0x62, 0x1a, 0x79, 0x9e, 0x29, 0x83, 0x39, 0x24, 0x98, 0xae, 0xcc, 0x32,
+    0x0c, 0x83, 0x90, 0x3e, 0x84, 0x3b, 0xbb, 0xca, 0x9e, 0xf3, 0x7b, 0x03, 0x99, 0x07, 0xda, 0x56,
+    0x51, 0xb4, 0x2c, 0xc6, 0x28, 0x4a, 0x95, 0x23, 0x18, 0xcf, 0x62, 0xa4, 0x9d, 0x10, 0xea, 0x4e,
+    0xc2, 0x38, 0x68, 0x0a, 0x08, 0xac, 0x75, 0x2b, 0x8c, 0xdf, 0x28, 0x1b, 0xf3, 0x6e, 0x9f, 0xf7,
+    0x8d, 0x57, 0xd5, 0x40, 0x3d, 0xaa, 0x35, 0x5b, 0x0b, 0xc7, 0x24, 0x82, 0xb6, 0xb6, 0x2c, 0x30,
+    0x71, 0xfb, 0x3a, 0x70, 0x7b, 0x29, 0x05, 0xfa, 0x1c, 0x1c, 0x74, 0x59, 0xf5, 0x2b, 0x7b, 0x3a,
+    0x0d, 0xc1, 0xec, 0x2e, 0xec, 0x93, 0x69, 0x7f, 0xfc, 0x74, 0x61, 0x9d, 0x18, 0x17, 0xc2, 0xf5,
+    0x22, 0x43, 0x4c, 0xd2, 0x2f, 0x71, 0xec, 0x00, 0xcb, 0x43, 0x11, 0x1b, 0x4c, 0x16, 0x62, 0x42,
+    0x98, 0xd0, 0xf9, 0x0e, 0x84, 0xf4, 0xbb, 0x96, 0x3a, 0x37, 0xeb, 0x14, 0x39, 0x78, 0x4c, 0x3b,
+    0xe5, 0x44, 0x22, 0x6b, 0x35, 0xd8, 0x84, 0xd3, 0x0e, 0xc3, 0xb2, 0xd6, 0x1d, 0x16, 0xda, 0xaa,
+    0xd9, 0x6b, 0x49, 0x9f, 0x8e, 0x2e, 0x13, 0xfa, 0xb4, 0x62, 0x46, 0x4b, 0xc8, 0xf1, 0xec, 0x3f,
+    0xf5, 0x85, 0xe1, 0x4a, 0x68, 0x12, 0x00, 0x00,
+};
+constexpr size_t PORTAL_JS_GZ_LEN = sizeof(PORTAL_JS_GZ);
+
+constexpr char PORTAL_CSS_PATH[] = "/portal-13f326c6.css";
+constexpr char PORTAL_JS_PATH[] = "/portal-e6ebddd1.js";
+
+// PORTAL_HTML: 1639 bytes source, 1228 minified, 580 gzipped
+constexpr size_t PORTAL_HTML_SIZE = 1228;
+constexpr char PORTAL_HTML_HASH[] = "5a6f207ed051fe48";
+constexpr uint8_t PORTAL_HTML_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x54, 0xdf, 0x6f, 0xdb, 0x20,
+    0x10, 0xfe, 0x57, 0x18, 0x2f, 0x4b, 0xa5, 0x39, 0x5e, 0x5a, 0x29, 0x9a, 0x34, 0xdb, 0x0f, 0x6b,
+    0x1b, 0x69, 0x52, 0xd5, 0x55, 0x4a, 0xa7, 0x69, 0x8f, 0x18, 0x2e, 0x31, 0x0b, 0x06, 0x0f, 0x70,
+    0xb2, 0xfc, 0xf7, 0x3b, 0xc0, 0x89, 0x93, 0x34, 0xd3, 0x5e, 0x2c, 0xee, 0xb8, 0x1f, 0xdf, 0x7d,
+    0xf7, 0xe1, 0xe2, 0xdd, 0xc3, 0xb7, 0xfb, 0xd7, 0x9f, 0x2f, 0x8f, 0xa4, 0xf1, 0xad, 0xaa, 0x8a,
+    0xf0, 0x25, 0x8a, 0xe9, 0x75, 0x49, 0x41, 0x53, 0xb4, 0x81, 0x89, 0xaa, 0x68, 0xc1, 0x33, 0xc2,
+    0x1b, 0x66, 0x1d, 0xf8, 0x92, 0x7e, 0x7f, 0x5d, 0x64, 0x9f, 0xe8, 0xe0, 0xd5, 0xac, 0x85, 0x92,
+    0x6e, 0x25, 0xec, 0x3a, 0x63, 0x3d, 0x25, 0xdc, 0x68, 0x0f, 0x1a, 0xa3, 0x76, 0x52, 0xf8, 0xa6,
+    0x14, 0xb0, 0x95, 0x1c, 0xb2, 0x68, 0x7c, 0x20, 0x52, 0x4b, 0x2f, 0x99, 0xca, 0x1c, 0x67, 0x0a,
+    0xca, 0xd9, 0xf4, 0x23, 0x56, 0xf1, 0xd2, 0x2b, 0xa8, 0x7e, 0xc8, 0x85, 0x24, 0xf7, 0x46, 0xaf,
+    0xe4, 0xba, 0xb7, 0xcc, 0x4b, 0xa3, 0x8b, 0x3c, 0xdd, 0x14, 0x4a, 0xea, 0x0d, 0xb1, 0xa0, 0x4a,
+    0xea, 0xfc, 0x5e, 0x81, 0x6b, 0x00, 0xb0, 0x4f, 0x63, 0x61, 0x55, 0xd2, 0x3c, 0x34, 0xc5, 0x82,
+    0xb3, 0xbb, 0xd5, 0xdd, 0xed, 0x9c, 0xcf, 0xa7, 0xdc, 0x39, 0xfa, 0x9f, 0x14, 0xdf, 0x40, 0x0b,
+    0x43, 0x60, 0x9e, 0xe6, 0xab, 0x8d, 0xd8, 0x57, 0x85, 0x90, 0x5b, 0xc2, 0x15, 0x73, 0xae, 0xa4,
+    0x61, 0x0a, 0x26, 0x35, 0x58, 0x7a, 0xe6, 0x0e, 0xd1, 0xd1, 0xd7, 0xcc, 0xae, 0x22, 0x46, 0x77,
+    0xd1, 0x55, 0x07, 0x27, 0x90, 0xbd, 0xe9, 0x2d, 0x49, 0x14, 0xbc, 0x77, 0x44, 0x83, 0xdf, 0x19,
+    0xbb, 0x09, 0x14, 0x69, 0xe0, 0x29, 0xa3, 0x43, 0x0c, 0xd8, 0xe0, 0x4d, 0x73, 0xa4, 0x70, 0x68,
+    0x2d, 0x45, 0x98, 0x82, 0xf9, 0xde, 0xd1, 0x43, 0x40, 0x32, 0x49, 0x23, 0x85, 0x88, 0x4b, 0x4a,
+    0x15, 0xea, 0xde, 0x7b, 0xa3, 0x8f, 0x31, 0x9c, 0xe9, 0xac, 0xf6, 0x9a, 0x12, 0xa3, 0xb9, 0x92,
+    0x7c, 0x93, 0x5c, 0xcf, 0x09, 0x83, 0x9b, 0xdc, 0x7c, 0xa6, 0xd5, 0x12, 0x1d, 0x64, 0x65, 0x2c,
+    0x39, 0x78, 0x8b, 0x3c, 0x15, 0x19, 0x3b, 0x0f, 0x98, 0xc7, 0xde, 0x83, 0x23, 0x53, 0xd2, 0xf9,
+    0x4b, 0x04, 0x58, 0xaa, 0x8d, 0x59, 0x3c, 0x32, 0xb0, 0x40, 0x33, 0xb4, 0x77, 0x7d, 0xdd, 0x4a,
+    0x54, 0x84, 0x05, 0xdf, 0x5b, 0x4d, 0x1c, 0xdb, 0x42, 0xa2, 0x68, 0x02, 0x5b, 0x9c, 0x33, 0x20,
+    0x39, 0x1d, 0x3f, 0x54, 0xc9, 0xd6, 0xd6, 0xf4, 0x5d, 0xd8, 0x24, 0xab, 0x41, 0x05, 0x8c, 0x08,
+    0xdf, 0x49, 0x41, 0xab, 0x01, 0x2a, 0x79, 0x46, 0xdd, 0x91, 0xc9, 0x72, 0xf9, 0xf5, 0xe1, 0xa6,
+    0xc8, 0x63, 0x54, 0x55, 0x48, 0xdd, 0xf5, 0x9e, 0xf8, 0x7d, 0x87, 0x8a, 0xf4, 0xf0, 0x07, 0x57,
+    0x1e, 0xc9, 0x0b, 0x79, 0x83, 0x4e, 0xd3, 0xd9, 0xc2, 0xef, 0x5e, 0x5a, 0x10, 0xa4, 0x53, 0x8c,
+    0x43, 0x63, 0x14, 0x2e, 0xb5, 0xa4, 0x8f, 0xc8, 0xba, 0x25, 0xc8, 0x86, 0x03, 0x85, 0xeb, 0x39,
+    0xac, 0x8b, 0x5e, 0xd9, 0xd0, 0xbf, 0x20, 0x76, 0x78, 0x8b, 0x39, 0x08, 0xf3, 0x65, 0x38, 0x5d,
+    0xc5, 0x76, 0x0c, 0x8b, 0xf8, 0x46, 0x2b, 0x61, 0x1c, 0xed, 0x33, 0x78, 0x4f, 0x80, 0xbc, 0x91,
+    0x1a, 0xdf, 0xe6, 0x26, 0xee, 0xcc, 0x74, 0xa0, 0xc9, 0x71, 0x3d, 0x17, 0x22, 0x48, 0x7d, 0x12,
+    0xf1, 0x03, 0x0b, 0xf1, 0xfc, 0x05, 0x05, 0x51, 0x2d, 0x43, 0xa1, 0x0b, 0xe5, 0x1e, 0xf6, 0x9e,
+    0x87, 0xd1, 0x4e, 0x84, 0x87, 0xa1, 0x62, 0xd4, 0x5d, 0xb0, 0xc6, 0xa5, 0x37, 0xb7, 0xb1, 0x94,
+    0x38, 0x91, 0x0f, 0xba, 0xce, 0x73, 0x9f, 0x50, 0x26, 0x57, 0xb5, 0x73, 0x44, 0xfc, 0xf6, 0xeb,
+    0xb8, 0x95, 0x9d, 0x27, 0xce, 0xf2, 0xf1, 0x81, 0xc3, 0x1c, 0x6a, 0x21, 0xc4, 0x6c, 0xfa, 0x2b,
+    0xce, 0x9a, 0x42, 0xf0, 0x90, 0x5e, 0x6e, 0x1e, 0x7f, 0x5e, 0x7f, 0x01, 0x7a, 0x10, 0x44, 0xb7,
+    0xcc, 0x04, 0x00, 0x00,
+};
+constexpr size_t PORTAL_HTML_GZ_LEN = sizeof(PORTAL_HTML_GZ);
+
+// PORTAL_HTML_RESET: 2125 bytes source, 1570 minified, 669 gzipped
+constexpr size_t PORTAL_HTML_RESET_SIZE = 1570;
+constexpr char PORTAL_HTML_RESET_HASH[] = "b10f398a14c64bb6";
+constexpr uint8_t PORTAL_HTML_RESET_GZ[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x55, 0x6d, 0x6f, 0xd3, 0x30,
+    0x10, 0xfe, 0x2b, 0xc6, 0x5f, 0xe8, 0x24, 0xb2, 0xd0, 0x4d, 0x9a, 0x90, 0x48, 0x22, 0xc1, 0x5e,
+    0x24, 0xa4, 0x69, 0x43, 0x74, 0x08, 0xf1, 0x09, 0x39, 0xf6, 0xb5, 0x31, 0x75, 0xec, 0x60, 0x3b,
+    0x1d, 0xfd, 0xf7, 0x9c, 0xed, 0xa4, 0x69, 0x4b, 0x11, 0xfb, 0x12, 0xf9, 0xce, 0xe7, 0xbb, 0xc7,
+    0xcf, 0x3d, 0xe7, 0x14, 0xaf, 0x6e, 0x1e, 0xaf, 0x9f, 0xbe, 0x7f, 0xbe, 0x25, 0x8d, 0x6f, 0x55,
+    0x55, 0x84, 0x2f, 0x51, 0x4c, 0xaf, 0x4a, 0x0a, 0x9a, 0xa2, 0x0d, 0x4c, 0x54, 0x45, 0x0b, 0x9e,
+    0x11, 0xde, 0x30, 0xeb, 0xc0, 0x97, 0xf4, 0xeb, 0xd3, 0x5d, 0xf6, 0x8e, 0x0e, 0x5e, 0xcd, 0x5a,
+    0x28, 0xe9, 0x46, 0xc2, 0x73, 0x67, 0xac, 0xa7, 0x84, 0x1b, 0xed, 0x41, 0x63, 0xd4, 0xb3, 0x14,
+    0xbe, 0x29, 0x05, 0x6c, 0x24, 0x87, 0x2c, 0x1a, 0x6f, 0x88, 0xd4, 0xd2, 0x4b, 0xa6, 0x32, 0xc7,
+    0x99, 0x82, 0x72, 0x7e, 0xfe, 0x16, 0xb3, 0x78, 0xe9, 0x15, 0x54, 0xdf, 0xe4, 0x9d, 0x24, 0xd7,
+    0x46, 0x2f, 0xe5, 0xaa, 0xb7, 0xcc, 0x4b, 0xa3, 0x8b, 0x3c, 0xed, 0x14, 0x4a, 0xea, 0x35, 0xb1,
+    0xa0, 0x4a, 0xea, 0xfc, 0x56, 0x81, 0x6b, 0x00, 0xb0, 0x4e, 0x63, 0x61, 0x59, 0xd2, 0x3c, 0x14,
+    0xc5, 0x84, 0xf3, 0xcb, 0xe5, 0xe5, 0xc5, 0x15, 0xbf, 0x3a, 0xe7, 0xce, 0xd1, 0xff, 0x1c, 0xf1,
+    0x0d, 0xb4, 0x30, 0x04, 0xe6, 0xe9, 0x7e, 0xb5, 0x11, 0xdb, 0xaa, 0x10, 0x72, 0x43, 0xb8, 0x62,
+    0xce, 0x95, 0x34, 0xdc, 0x82, 0x49, 0x0d, 0x96, 0x1e, 0xb8, 0x43, 0x74, 0xf4, 0x35, 0xf3, 0x93,
+    0x88, 0xd1, 0x5d, 0x74, 0xd5, 0xe8, 0x04, 0xb2, 0x35, 0xbd, 0x25, 0x89, 0x82, 0xd7, 0x8e, 0x68,
+    0xf0, 0xcf, 0xc6, 0xae, 0x03, 0x45, 0x1a, 0x78, 0x3a, 0xd1, 0x21, 0x06, 0x2c, 0xf0, 0x57, 0x71,
+    0xa4, 0x70, 0x28, 0x2d, 0x45, 0xb8, 0x05, 0xf3, 0xbd, 0xa3, 0x63, 0x40, 0x32, 0x49, 0x23, 0x85,
+    0x88, 0x4d, 0x4a, 0x19, 0xea, 0xde, 0x7b, 0xa3, 0x77, 0x31, 0x9c, 0xe9, 0xac, 0xf6, 0x9a, 0x12,
+    0xa3, 0xb9, 0x92, 0x7c, 0x9d, 0x5c, 0x0f, 0x09, 0x83, 0x9b, 0x9d, 0xbd, 0xa7, 0xd5, 0x02, 0x1d,
+    0x64, 0x69, 0x2c, 0x19, 0xbd, 0x45, 0x9e, 0x92, 0x4c, 0x95, 0x07, 0xcc, 0x53, 0xed, 0xc1, 0x91,
+    0x29, 0xe9, 0xfc, 0x31, 0x02, 0x4c, 0xd5, 0xc6, 0x53, 0x3c, 0x32, 0x70, 0x87, 0x66, 0x28, 0xef,
+    0xfa, 0xba, 0x95, 0xa8, 0x08, 0x0b, 0xbe, 0xb7, 0x9a, 0x38, 0xb6, 0x81, 0x44, 0xd1, 0x0c, 0x36,
+    0x78, 0xcf, 0x80, 0x64, 0xff, 0xfa, 0x21, 0x4b, 0xb6, 0xb2, 0xa6, 0xef, 0x42, 0x27, 0x59, 0x0d,
+    0x2a, 0x60, 0x44, 0xf8, 0x4e, 0x0a, 0x5a, 0x0d, 0x50, 0xc9, 0x03, 0xea, 0x8e, 0xcc, 0x16, 0x8b,
+    0x4f, 0x37, 0x67, 0x45, 0x1e, 0xa3, 0xaa, 0x42, 0xea, 0xae, 0xf7, 0xc4, 0x6f, 0x3b, 0x54, 0xa4,
+    0x87, 0xdf, 0xd8, 0xf2, 0x48, 0x5e, 0x38, 0x37, 0xe8, 0x34, 0xad, 0x2d, 0xfc, 0xea, 0xa5, 0x05,
+    0x41, 0x3a, 0xc5, 0x38, 0x34, 0x46, 0x61, 0x53, 0x4b, 0x7a, 0x8b, 0xac, 0x5b, 0x82, 0x6c, 0x38,
+    0x50, 0xd8, 0x9e, 0xb1, 0x5d, 0xf4, 0x44, 0x87, 0xfe, 0x05, 0xb1, 0xc3, 0x5d, 0x3c, 0x83, 0x30,
+    0x3f, 0x0f, 0xab, 0x93, 0xd8, 0x76, 0x61, 0x11, 0xdf, 0x64, 0x25, 0x8c, 0x93, 0x7d, 0x00, 0xef,
+    0x1e, 0x90, 0x37, 0x52, 0xe3, 0x6c, 0xae, 0x63, 0xcf, 0x4c, 0x07, 0x9a, 0xec, 0xda, 0x73, 0x24,
+    0x82, 0x54, 0x27, 0x19, 0xbb, 0xd6, 0x79, 0xb3, 0x5a, 0x29, 0xc8, 0x98, 0xd8, 0x30, 0xcd, 0x41,
+    0xec, 0x29, 0x23, 0xed, 0x7c, 0x18, 0x36, 0xa2, 0x36, 0x46, 0x83, 0x3c, 0x76, 0x41, 0xa9, 0x27,
+    0xa4, 0x31, 0xe5, 0x19, 0xf2, 0x8f, 0x8e, 0x49, 0x16, 0x2f, 0xa0, 0xcc, 0x02, 0xbe, 0x29, 0x3f,
+    0x26, 0xe2, 0xbe, 0x04, 0x9b, 0x8c, 0xf4, 0x91, 0x59, 0x2a, 0xcf, 0xd4, 0xd9, 0x0b, 0x98, 0x3c,
+    0xca, 0x35, 0xf0, 0x79, 0xec, 0x3d, 0x60, 0x15, 0x35, 0x8a, 0x72, 0x68, 0x8d, 0x87, 0x61, 0x4e,
+    0x49, 0x0c, 0xdf, 0xf1, 0x79, 0x82, 0xd5, 0x24, 0xe7, 0x41, 0x5b, 0x71, 0xfd, 0x11, 0xc7, 0xac,
+    0x5a, 0x84, 0xf6, 0x1c, 0xbd, 0x07, 0x23, 0x65, 0x79, 0xb8, 0xfd, 0xde, 0x38, 0x63, 0xe8, 0x44,
+    0x5b, 0xb4, 0x26, 0xce, 0x9a, 0x8b, 0x98, 0x4a, 0xec, 0x0d, 0x25, 0xba, 0x0e, 0xcf, 0xde, 0xe3,
+    0xf0, 0x9d, 0x9c, 0xc8, 0x23, 0xdc, 0xfb, 0x5f, 0xc7, 0xad, 0xec, 0x3c, 0x71, 0x96, 0x4f, 0xcf,
+    0x26, 0x5c, 0x41, 0x2d, 0x84, 0x98, 0x9f, 0xff, 0x8c, 0x0a, 0x4a, 0x21, 0xb8, 0x48, 0xef, 0x61,
+    0x1e, 0x7f, 0x09, 0x7f, 0x00, 0x82, 0xde, 0xa5, 0x4c, 0x22, 0x06, 0x00, 0x00,
+};
+constexpr size_t PORTAL_HTML_RESET_GZ_LEN = sizeof(PORTAL_HTML_RESET_GZ);
+
+#endif // ESP32_PROVISION_TOOLKIT_PORTAL_ASSETS_H